@@ -0,0 +1,102 @@
+#include <bits/stdc++.h>
+#include "GraphGenerators.cpp"
+#include "../UnionFind/UnionFind.cpp"
+using namespace std;
+
+// Generation rates for every family in GraphGenerators.cpp, a check that the
+// output does not depend on the thread count, and each graph pushed through
+// UnionFind to show what it does to connectivity benchmarks.
+
+unsigned long long fingerprint(const vector<Edge>& edges) {
+    unsigned long long h = 0;
+    for (size_t i = 0; i < edges.size(); i++) {
+        h += gen_detail::mix(i ^ ((unsigned long long)edges[i].first << 32 | (unsigned)edges[i].second));
+    }
+    return h;
+}
+
+template <class Generator>
+void report(const string& name, const Generator& g, int threads) {
+    vector<Edge> edges;
+    auto start = chrono::high_resolution_clock::now();
+    generateEdges(g, edges, threads);
+    auto end = chrono::high_resolution_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+
+    vector<Edge> single;
+    generateEdges(g, single, 1);
+    bool same = fingerprint(edges) == fingerprint(single);
+
+    int n = g.vertexCount();
+    UnionFind uf(n);
+    start = chrono::high_resolution_clock::now();
+    for (auto& e : edges) uf.unionSets(e.first, e.second);
+    end = chrono::high_resolution_clock::now();
+    long long components = 0;
+    for (int v = 0; v < n; v++) components += uf.find(v) == v;
+
+    cout << "  " << left << setw(24) << name << right << setw(10) << edges.size() << " edges, " << setw(6)
+         << (long long)(edges.size() / seconds / 1e6) << " M edges/s, " << (same ? "same" : "DIFFERENT")
+         << " with 1 thread; UnionFind " << setw(5) << chrono::duration_cast<chrono::milliseconds>(end - start).count()
+         << " ms, " << components << " components" << endl;
+}
+
+int main() {
+    int threads = max(1u, thread::hardware_concurrency());
+    cout << "Materialized into edge arrays (" << threads << " thread(s)):" << endl;
+    report("R-MAT scale 21", RMat(21, 16 << 21, 0.45, 0.15, 0.15, 1), threads);
+    report("Kronecker scale 21", Kronecker(21, 16, 2), threads);
+    report("G(n, m)", ErdosRenyi{1 << 21, 16 << 21, 3}, threads);
+    report("2D grid 4096^2", Grid2D{4096, 4096}, threads);
+    report("3D grid 256^3", Grid3D{256, 256, 256}, threads);
+    report("path (relabelled)", Path{1 << 24, 4, true}, threads);
+    report("star", Star{1 << 24}, threads);
+    report("adversarial chains", AdversarialChains{16, 1 << 20}, threads);
+
+    // the adversarial input against plain index linking; kept to 2^16 because
+    // UnionFind::find recurses once per level and a 2^20 chain overflows the stack
+    {
+        AdversarialChains g{1, 1 << 16};
+        vector<Edge> edges;
+        generateEdges(g, edges, threads);
+        for (bool byRank : {true, false}) {
+            UnionFind uf(g.vertexCount());
+            for (auto& e : edges) uf.unionSets(e.first, e.second, byRank);
+            // depth of the first element before any compressing find touches it
+            auto start = chrono::high_resolution_clock::now();
+            uf.find(0);
+            auto us = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count();
+            cout << "  chain of 2^16, " << (byRank ? "union by rank:   " : "union by index:  ") << "first find(0) "
+                 << us << " microseconds" << endl;
+        }
+    }
+
+    // streamed without storing: 2^30 G(n, m) edges, only summarized per block
+    {
+        ErdosRenyi g{1 << 30, 1ULL << 30, 5};
+        vector<unsigned long long> perThread(threads, 0);
+        auto start = chrono::high_resolution_clock::now();
+        streamEdges(g, threads, [&](int t, size_t, const Edge* block, size_t count) {
+            unsigned long long x = 0;
+            for (size_t k = 0; k < count; k++) x += block[k].first ^ block[k].second;
+            perThread[t] += x;
+        });
+        double seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        cout << "Streamed " << g.edgeCount() << " G(n, m) edges in " << fixed << setprecision(1) << seconds << " s ("
+             << g.edgeCount() / seconds / 1e6 << " M edges/s, checksum "
+             << accumulate(perThread.begin(), perThread.end(), 0ULL) % 1000003 << ")" << endl;
+    }
+
+    // CSR for the 2D grid
+    {
+        Grid2D g{4096, 4096};
+        vector<Edge> edges;
+        generateEdges(g, edges, threads);
+        auto start = chrono::high_resolution_clock::now();
+        CSRGraph csr = toCSR(g.vertexCount(), edges, threads);
+        auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+        cout << "CSR of the 2D grid: " << csr.n << " vertices, " << csr.adj.size() << " adjacency entries, " << ms
+             << " ms, degree of vertex 4097 = " << csr.offsets[4098] - csr.offsets[4097] << endl;
+    }
+    return 0;
+}
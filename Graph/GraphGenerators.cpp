@@ -0,0 +1,326 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Seedable synthetic graph generators for connectivity benchmarks.
+//
+// Every generator is a small value type with
+//   size_t edgeCount() const
+//   Edge operator()(size_t i) const      // the i-th edge
+// Edge i is a pure function of (parameters, seed, i): random choices come
+// from a counter-based hash of the edge index, never from a shared RNG
+// stream. So any thread can produce any range of edges independently, the
+// output is identical for every thread count, and a huge graph can be
+// streamed block by block (streamEdges) without ever materializing it.
+//
+//   RMat           recursive-matrix graph on 2^scale vertices; one hash
+//                  yields quadrant choices for 8 levels via a 256-way alias
+//                  table. Kronecker() gives the Graph500 parameters with
+//                  scrambled vertex ids.
+//   ErdosRenyi     G(n, m): m endpoints pairs uniform over [0, n)
+//                  (sampled with replacement, so multi-edges can occur)
+//   Grid2D/Grid3D  lattices, edges to the +x / +y / +z neighbour
+//   Path           0-1-2-..., optionally under a random relabelling
+//   Star           centre 0 joined to every other vertex
+//   AdversarialChains  k chains whose edges (i + 1, i) arrive in order, so
+//                  UnionFind::unionSets(u, v, false) builds paths of full
+//                  chain length
+//
+// toCSR() turns any edge array into symmetric CSR in parallel.
+
+typedef pair<int, int> Edge;
+
+namespace gen_detail {
+
+inline uint64_t mix(uint64_t x) {
+    // splitmix64 finalizer
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t edgeHash(uint64_t seed, uint64_t i, uint64_t stream = 0) { return mix(seed ^ mix(i * 4 + stream)); }
+
+// uniform in [0, n) from 32 random bits (Lemire's multiply-shift)
+inline uint32_t below(uint32_t random, uint32_t n) { return (uint32_t)(((uint64_t)random * n) >> 32); }
+
+// bijection on [0, 2^bits): odd multiply + xorshift, both invertible mod 2^bits
+inline uint64_t scramble(uint64_t x, int bits, uint64_t seed) {
+    uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    x = (x * (mix(seed) | 1)) & mask;
+    x ^= x >> (bits / 2 + 1);
+    x = (x * (mix(seed + 1) | 1)) & mask;
+    return x;
+}
+
+}  // namespace gen_detail
+
+struct RMat {
+    int scale;
+    size_t m;
+    uint64_t seed;
+    bool scrambleIds;
+    // 256-way alias table over 4 levels of quadrant choices (2 bits each);
+    // keep slot k when a 24-bit coin is below threshold[k], else take alias[k]
+    array<uint32_t, 256> threshold;
+    array<uint8_t, 256> alias;
+    array<uint8_t, 256> uBits, vBits;  // the 4 row / column bits slot k stands for
+
+    RMat(int scale, size_t m, double a, double b, double c, uint64_t seed, bool scrambleIds = false)
+        : scale(scale), m(m), seed(seed), scrambleIds(scrambleIds) {
+        double quad[4] = {a, b, c, 1 - a - b - c};
+        vector<double> p(256);
+        for (int k = 0; k < 256; k++) {
+            p[k] = 256.0;
+            for (int level = 0; level < 4; level++) p[k] *= quad[(k >> (2 * level)) & 3];
+        }
+        // Vose's alias method
+        vector<int> small, large;
+        for (int k = 0; k < 256; k++) (p[k] < 1 ? small : large).push_back(k);
+        for (int k = 0; k < 256; k++) {
+            alias[k] = k;
+            uBits[k] = vBits[k] = 0;
+            for (int level = 0; level < 4; level++) {
+                uBits[k] = uBits[k] << 1 | ((k >> (2 * level + 1)) & 1);
+                vBits[k] = vBits[k] << 1 | ((k >> (2 * level)) & 1);
+            }
+        }
+        threshold.fill(1 << 24);
+        while (!small.empty() && !large.empty()) {
+            int s = small.back(), l = large.back();
+            small.pop_back();
+            threshold[s] = (uint32_t)(p[s] * (1 << 24));
+            alias[s] = l;
+            p[l] -= 1 - p[s];
+            if (p[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+    }
+
+    size_t edgeCount() const { return m; }
+
+    Edge operator()(size_t i) const {
+        // draw whole 4-level chunks, then drop the surplus low levels
+        uint64_t u = 0, v = 0;
+        int chunks = (scale + 3) / 4;
+        for (int c = 0; c < chunks; c += 2) {
+            uint64_t r = gen_detail::edgeHash(seed, i, c / 2);
+            // each 32-bit half: 8 bits of slot, 24 bits of coin against the threshold
+            for (int half = 0; half < 2 && c + half < chunks; half++, r >>= 32) {
+                uint32_t slot = r & 255, coin = (uint32_t)r >> 8;
+                // branch-free select: the coin flip is unpredictable by design
+                uint32_t k = slot ^ ((slot ^ alias[slot]) & -(uint32_t)(coin >= threshold[slot]));
+                u = u << 4 | uBits[k];
+                v = v << 4 | vBits[k];
+            }
+        }
+        u >>= 4 * chunks - scale;
+        v >>= 4 * chunks - scale;
+        if (scrambleIds) {
+            u = gen_detail::scramble(u, scale, seed);
+            v = gen_detail::scramble(v, scale, seed);
+        }
+        return {(int)u, (int)v};
+    }
+
+    int vertexCount() const { return 1 << scale; }
+};
+
+// Graph500 Kronecker generator parameters: A = 0.57, B = C = 0.19, scrambled ids
+inline RMat Kronecker(int scale, int edgeFactor, uint64_t seed) {
+    return RMat(scale, (size_t)edgeFactor << scale, 0.57, 0.19, 0.19, seed, true);
+}
+
+struct ErdosRenyi {
+    int n;
+    size_t m;
+    uint64_t seed;
+
+    size_t edgeCount() const { return m; }
+    Edge operator()(size_t i) const {
+        uint64_t r = gen_detail::edgeHash(seed, i);
+        return {(int)gen_detail::below(r, n), (int)gen_detail::below(r >> 32, n)};
+    }
+    int vertexCount() const { return n; }
+};
+
+struct Grid2D {
+    int w, h;
+
+    size_t edgeCount() const { return (size_t)(w - 1) * h + (size_t)w * (h - 1); }
+    Edge operator()(size_t i) const {
+        size_t horizontal = (size_t)(w - 1) * h;
+        if (i < horizontal) {
+            int y = i / (w - 1), x = i % (w - 1);
+            int v = y * w + x;
+            return {v, v + 1};
+        }
+        i -= horizontal;
+        return {(int)i, (int)(i + w)};
+    }
+    int vertexCount() const { return w * h; }
+};
+
+struct Grid3D {
+    int x, y, z;
+
+    size_t edgeCount() const {
+        return (size_t)(x - 1) * y * z + (size_t)x * (y - 1) * z + (size_t)x * y * (z - 1);
+    }
+    Edge operator()(size_t i) const {
+        size_t alongX = (size_t)(x - 1) * y * z, alongY = (size_t)x * (y - 1) * z;
+        if (i < alongX) {
+            size_t row = i / (x - 1);  // (iz, iy) row index
+            int v = row * x + i % (x - 1);
+            return {v, v + 1};
+        }
+        i -= alongX;
+        if (i < alongY) {
+            size_t plane = i / ((size_t)x * (y - 1)), inPlane = i % ((size_t)x * (y - 1));
+            int v = plane * x * y + inPlane;
+            return {v, v + x};
+        }
+        i -= alongY;
+        return {(int)i, (int)(i + (size_t)x * y)};
+    }
+    int vertexCount() const { return x * y * z; }
+};
+
+struct Path {
+    int n;
+    uint64_t seed;
+    bool relabel;  // scramble ids so the path is not laid out in memory order
+
+    size_t edgeCount() const { return n - 1; }
+    Edge operator()(size_t i) const {
+        if (!relabel) return {(int)i, (int)i + 1};
+        return {label(i), label(i + 1)};
+    }
+    int vertexCount() const { return n; }
+
+   private:
+    int label(uint64_t x) const {
+        // cycle-walk the power-of-two bijection until it lands inside [0, n)
+        int bits = 1;
+        while ((1ULL << bits) < (uint64_t)n) bits++;
+        do x = gen_detail::scramble(x, bits, seed);
+        while (x >= (uint64_t)n);
+        return x;
+    }
+};
+
+struct Star {
+    int n;
+
+    size_t edgeCount() const { return n - 1; }
+    Edge operator()(size_t i) const { return {0, (int)i + 1}; }
+    int vertexCount() const { return n; }
+};
+
+struct AdversarialChains {
+    int chains, length;
+
+    size_t edgeCount() const { return (size_t)chains * (length - 1); }
+    Edge operator()(size_t i) const {
+        size_t c = i / (length - 1), k = i % (length - 1);
+        int first = c * length;
+        return {first + (int)k + 1, first + (int)k};  // newcomer first: its root adopts the whole chain
+    }
+    int vertexCount() const { return chains * length; }
+};
+
+// Calls sink(thread, firstIndex, edges, count) with consecutive blocks of the
+// graph; each thread owns a contiguous index range and reuses one buffer.
+template <class Generator, class Sink>
+void streamEdges(const Generator& g, int threads, Sink sink, size_t blockSize = 1 << 16) {
+    size_t m = g.edgeCount();
+    threads = max(1, threads);
+    auto work = [&](int t) {
+        vector<Edge> block(blockSize);
+        size_t lo = m * t / threads, hi = m * (t + 1) / threads;
+        for (size_t start = lo; start < hi; start += blockSize) {
+            size_t count = min(blockSize, hi - start);
+            for (size_t k = 0; k < count; k++) block[k] = g(start + k);
+            sink(t, start, block.data(), count);
+        }
+    };
+    if (threads == 1) {
+        work(0);
+        return;
+    }
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(work, t);
+    for (auto& th : pool) th.join();
+}
+
+// Writes the whole graph into `edges` (resized to edgeCount()).
+template <class Generator>
+void generateEdges(const Generator& g, vector<Edge>& edges, int threads = thread::hardware_concurrency()) {
+    size_t m = g.edgeCount();
+    edges.resize(m);
+    threads = max(1, threads);
+    auto work = [&](int t) {
+        for (size_t i = m * t / threads; i < m * (t + 1) / threads; i++) edges[i] = g(i);
+    };
+    if (threads == 1) {
+        work(0);
+        return;
+    }
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(work, t);
+    for (auto& th : pool) th.join();
+}
+
+struct CSRGraph {
+    int n = 0;
+    vector<long long> offsets;  // size n + 1
+    vector<int> adj;
+};
+
+// Symmetric CSR (each edge stored in both rows); neighbour order within a row
+// depends on thread timing unless threads == 1.
+CSRGraph toCSR(int n, const vector<Edge>& edges, int threads = thread::hardware_concurrency()) {
+    threads = max(1, threads);
+    size_t m = edges.size();
+    CSRGraph g;
+    g.n = n;
+    unique_ptr<atomic<long long>[]> cursor(new atomic<long long>[n + 1]);
+    auto parallel = [&](auto body) {
+        if (threads == 1) {
+            body(0);
+            return;
+        }
+        vector<thread> pool;
+        for (int t = 0; t < threads; t++) pool.emplace_back(body, t);
+        for (auto& th : pool) th.join();
+    };
+    parallel([&](int t) {
+        for (long long v = (long long)(n + 1) * t / threads; v < (long long)(n + 1) * (t + 1) / threads; v++) {
+            cursor[v].store(0, memory_order_relaxed);
+        }
+    });
+    parallel([&](int t) {
+        for (size_t i = m * t / threads; i < m * (t + 1) / threads; i++) {
+            cursor[edges[i].first + 1].fetch_add(1, memory_order_relaxed);
+            cursor[edges[i].second + 1].fetch_add(1, memory_order_relaxed);
+        }
+    });
+    g.offsets.resize(n + 1);
+    long long running = 0;
+    for (int v = 0; v <= n; v++) {
+        running += cursor[v].load(memory_order_relaxed);
+        g.offsets[v] = running;
+        cursor[v].store(running, memory_order_relaxed);
+    }
+    g.adj.resize(running);
+    parallel([&](int t) {
+        for (size_t i = m * t / threads; i < m * (t + 1) / threads; i++) {
+            auto [u, v] = edges[i];
+            g.adj[cursor[u].fetch_add(1, memory_order_relaxed)] = v;
+            g.adj[cursor[v].fetch_add(1, memory_order_relaxed)] = u;
+        }
+    });
+    return g;
+}
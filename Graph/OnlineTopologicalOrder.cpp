@@ -0,0 +1,212 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Incremental cycle detection for directed graphs (Pearce & Kelly, 2006).
+//
+// Union-Find can't do this (it forgets edge direction), so we keep a
+// topological order instead: ord[v] is v's position, and every arc x -> y
+// satisfies ord[x] < ord[y].
+//
+// Inserting x -> y:
+//   - ord[x] < ord[y]: already consistent, O(1).
+//   - otherwise only the "affected region" ord[y] .. ord[x] can be wrong.
+//     Forward DFS from y, restricted to ord <= ord[x]. If it reaches x, the
+//     arc would close a cycle and is rejected. Otherwise, backward DFS from x,
+//     restricted to ord >= ord[y]. Then reuse the positions those two sets
+//     held: backward set first, forward set after, each in its old relative
+//     order.
+// The work is bounded by the affected region rather than the whole graph.
+
+class OnlineTopologicalOrder {
+   private:
+    int n;
+    vector<vector<int>> out, in;
+    vector<int> ord;      // vertex -> position
+    vector<int> at;       // position -> vertex
+    vector<int> mark;     // visit stamp
+    int stamp = 0;
+    vector<int> deltaF, deltaB, stack, slots;
+
+    // false if x is reachable from y inside the affected region
+    bool forward(int y, int x, int ub) {
+        deltaF.clear();
+        stack.assign(1, y);
+        mark[y] = stamp;
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            deltaF.push_back(v);
+            for (int w : out[v]) {
+                if (w == x) return false;
+                if (mark[w] != stamp && ord[w] < ub) {
+                    mark[w] = stamp;
+                    stack.push_back(w);
+                }
+            }
+        }
+        return true;
+    }
+
+    void backward(int x, int lb) {
+        deltaB.clear();
+        stack.assign(1, x);
+        mark[x] = stamp;
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            deltaB.push_back(v);
+            for (int w : in[v]) {
+                if (mark[w] != stamp && ord[w] > lb) {
+                    mark[w] = stamp;
+                    stack.push_back(w);
+                }
+            }
+        }
+    }
+
+    void reorder() {
+        auto byOrd = [&](int a, int b) { return ord[a] < ord[b]; };
+        sort(deltaB.begin(), deltaB.end(), byOrd);
+        sort(deltaF.begin(), deltaF.end(), byOrd);
+        slots.clear();
+        for (int v : deltaB) slots.push_back(ord[v]);
+        for (int v : deltaF) slots.push_back(ord[v]);
+        sort(slots.begin(), slots.end());
+        size_t k = 0;
+        for (int v : deltaB) ord[v] = slots[k++], at[ord[v]] = v;
+        for (int v : deltaF) ord[v] = slots[k++], at[ord[v]] = v;
+    }
+
+   public:
+    OnlineTopologicalOrder(int n) : n(n), out(n), in(n), ord(n), at(n), mark(n, 0) {
+        for (int i = 0; i < n; i++) ord[i] = at[i] = i;
+    }
+
+    // insert x -> y; returns false (and leaves the graph unchanged) if it would close a cycle
+    bool addArc(int x, int y) {
+        if (x == y) return false;
+        int lb = ord[y], ub = ord[x];
+        if (lb < ub) {
+            ++stamp;
+            if (!forward(y, x, ub)) return false;
+            backward(x, lb);
+            reorder();
+        }
+        out[x].push_back(y);
+        in[y].push_back(x);
+        return true;
+    }
+
+    int position(int v) const { return ord[v]; }
+
+    // current topological order, first to last
+    const vector<int>& order() const { return at; }
+
+    bool verify() const {
+        for (int v = 0; v < n; v++) {
+            for (int w : out[v]) {
+                if (ord[v] >= ord[w]) return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Baseline: keep the graph, and before every insertion run a full DFS from y
+// looking for x.
+class DfsPerInsertion {
+   private:
+    vector<vector<int>> out;
+    vector<int> mark;
+    int stamp = 0;
+
+   public:
+    DfsPerInsertion(int n) : out(n), mark(n, 0) {}
+
+    bool addArc(int x, int y) {
+        if (x == y) return false;
+        ++stamp;
+        vector<int> stack = {y};
+        mark[y] = stamp;
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            if (v == x) return false;
+            for (int w : out[v]) {
+                if (mark[w] != stamp) {
+                    mark[w] = stamp;
+                    stack.push_back(w);
+                }
+            }
+        }
+        out[x].push_back(y);
+        return true;
+    }
+};
+
+// Dependency-graph-like arcs: mostly between nearby vertices of a hidden order
+// that roughly follows vertex ids (shuffled within blocks of 1024, like
+// packages declared in batches), plus some back arcs that must be rejected.
+vector<pair<int, int>> makeArcs(int n, long long m, unsigned seed) {
+    mt19937 rng(seed);
+    vector<int> hidden(n);
+    iota(hidden.begin(), hidden.end(), 0);
+    for (int b = 0; b < n; b += 1024) shuffle(hidden.begin() + b, hidden.begin() + min(n, b + 1024), rng);
+    vector<pair<int, int>> arcs(m);
+    for (auto& a : arcs) {
+        int i = rng() % n, span = 1 + rng() % 64;
+        int j = min(n - 1, i + span);
+        if (i == j) i = max(0, j - 1);
+        if (rng() % 100 == 0) swap(i, j);  // usually closes a cycle
+        a = {hidden[i], hidden[j]};
+    }
+    return arcs;
+}
+
+int main() {
+    // same input through both: identical accept / reject decisions expected
+    {
+        const int n = 20000;
+        const long long m = 100000;
+        vector<pair<int, int>> arcs = makeArcs(n, m, 1);
+
+        auto start = chrono::high_resolution_clock::now();
+        OnlineTopologicalOrder pk(n);
+        vector<char> pkAccepted(m);
+        for (long long i = 0; i < m; i++) pkAccepted[i] = pk.addArc(arcs[i].first, arcs[i].second);
+        auto end = chrono::high_resolution_clock::now();
+        auto pkUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+        start = chrono::high_resolution_clock::now();
+        DfsPerInsertion dfs(n);
+        long long disagreements = 0, rejected = 0;
+        for (long long i = 0; i < m; i++) {
+            bool ok = dfs.addArc(arcs[i].first, arcs[i].second);
+            if (ok != (bool)pkAccepted[i]) disagreements++;
+            if (!ok) rejected++;
+        }
+        end = chrono::high_resolution_clock::now();
+        auto dfsUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+        cout << m << " arcs on " << n << " vertices (" << rejected << " rejected):\n";
+        cout << "  Pearce-Kelly:        " << pkUs << " microseconds\n";
+        cout << "  full DFS per insert: " << dfsUs << " microseconds\n";
+        cout << "  disagreements: " << disagreements << ", order valid: " << (pk.verify() ? "yes" : "NO") << endl;
+    }
+
+    // scale: 10M arcs, too slow for the baseline
+    {
+        const int n = 1000000;
+        const long long m = 10000000;
+        vector<pair<int, int>> arcs = makeArcs(n, m, 2);
+        auto start = chrono::high_resolution_clock::now();
+        OnlineTopologicalOrder pk(n);
+        long long rejected = 0;
+        for (auto& a : arcs) rejected += !pk.addArc(a.first, a.second);
+        auto end = chrono::high_resolution_clock::now();
+        auto us = chrono::duration_cast<chrono::microseconds>(end - start).count();
+        cout << m << " arcs on " << n << " vertices: " << us << " microseconds (" << rejected
+             << " rejected), order valid: " << (pk.verify() ? "yes" : "NO") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <bits/stdc++.h>
+#include "LinkCutTree.cpp"
+#include "../UnionFind/UnionFind.cpp"
+using namespace std;
+
+// LinkCutTree.cpp checked against a brute-force forest on random link / cut /
+// path queries, then used for dynamic MST maintenance (checked against
+// Kruskal on UnionFind).
+
+// Reference answers by walking the forest with BFS.
+bool brutePath(const vector<vector<pair<int, long long>>>& adj, int u, int v, PathAggregate& out) {
+    int n = adj.size();
+    vector<int> prev(n, -2);
+    vector<long long> prevW(n);
+    queue<int> q;
+    q.push(u);
+    prev[u] = -1;
+    while (!q.empty()) {
+        int x = q.front();
+        q.pop();
+        for (auto& e : adj[x]) {
+            if (prev[e.first] != -2) continue;
+            prev[e.first] = x;
+            prevW[e.first] = e.second;
+            q.push(e.first);
+        }
+    }
+    if (prev[v] == -2) return false;
+    out.minWeight = LLONG_MAX, out.maxWeight = LLONG_MIN, out.sum = 0, out.edges = 0;
+    for (int x = v; x != u; x = prev[x]) {
+        out.minWeight = min(out.minWeight, prevW[x]);
+        out.maxWeight = max(out.maxWeight, prevW[x]);
+        out.sum += prevW[x];
+        out.edges++;
+    }
+    return true;
+}
+
+int main() {
+    // 1) random link / cut / path queries checked against a brute-force forest
+    {
+        const int n = 300;
+        LinkCutTree lct(n);
+        vector<vector<pair<int, long long>>> adj(n);
+        vector<pair<int, int>> edges;
+        mt19937 rng(5);
+        int mismatches = 0, checks = 0;
+        for (int step = 0; step < 100000; step++) {
+            int op = rng() % 3;
+            if (op == 0) {
+                int u = rng() % n, v = rng() % n;
+                long long w = rng() % 1000;
+                PathAggregate tmp;
+                bool wasConnected = u == v || brutePath(adj, u, v, tmp);
+                if (lct.link(u, v, w) == wasConnected) mismatches++;
+                if (!wasConnected) {
+                    adj[u].push_back({v, w});
+                    adj[v].push_back({u, w});
+                    edges.push_back({u, v});
+                }
+            } else if (op == 1 && !edges.empty()) {
+                int i = rng() % edges.size();
+                int u = edges[i].first, v = edges[i].second;
+                swap(edges[i], edges.back());
+                edges.pop_back();
+                if (!lct.cut(u, v)) mismatches++;
+                auto drop = [](vector<pair<int, long long>>& l, int x) {
+                    for (size_t k = 0; k < l.size(); k++) {
+                        if (l[k].first == x) {
+                            l.erase(l.begin() + k);
+                            return;
+                        }
+                    }
+                };
+                drop(adj[u], v);
+                drop(adj[v], u);
+            } else {
+                int u = rng() % n, v = rng() % n;
+                PathAggregate a, b;
+                bool x = lct.pathQuery(u, v, a), y = brutePath(adj, u, v, b);
+                checks++;
+                if (x != y || (x && (a.minWeight != b.minWeight || a.maxWeight != b.maxWeight ||
+                                     a.sum != b.sum || a.edges != b.edges))) {
+                    mismatches++;
+                }
+            }
+        }
+        cout << "Random forest: " << checks << " path queries checked, mismatches: " << mismatches << endl;
+    }
+
+    // 2) dynamic MST maintenance: insert edges one by one, keep the minimum
+    //    spanning forest by swapping out the heaviest edge on any cycle
+    {
+        const int n = 100000, m = 500000;
+        mt19937 rng(11);
+        vector<tuple<long long, int, int>> edges(m);
+        for (auto& e : edges) e = make_tuple((long long)(rng() % 1000000), (int)(rng() % n), (int)(rng() % n));
+
+        auto start = chrono::high_resolution_clock::now();
+        LinkCutTree lct(n);
+        long long total = 0;
+        for (auto& e : edges) {
+            long long w = get<0>(e);
+            int u = get<1>(e), v = get<2>(e);
+            if (u == v) continue;
+            PathAggregate path;
+            if (!lct.pathQuery(u, v, path)) {
+                lct.link(u, v, w);
+                total += w;
+            } else if (path.maxWeight > w) {
+                lct.cut(path.maxEdge.first, path.maxEdge.second);
+                lct.link(u, v, w);
+                total += w - path.maxWeight;
+            }
+        }
+        auto end = chrono::high_resolution_clock::now();
+        auto us = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+        // Kruskal with UnionFind over the final edge set gives the same weight
+        sort(edges.begin(), edges.end());
+        UnionFind uf(n);
+        long long kruskal = 0;
+        for (auto& e : edges) {
+            if (!uf.connected(get<1>(e), get<2>(e))) {
+                uf.unionSets(get<1>(e), get<2>(e));
+                kruskal += get<0>(e);
+            }
+        }
+        cout << "Dynamic MST over " << m << " insertions: " << us << " microseconds, weight " << total
+             << (total == kruskal ? " (matches Kruskal)" : " (DIFFERS from Kruskal)") << endl;
+    }
+    return 0;
+}
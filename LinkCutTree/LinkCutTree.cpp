@@ -0,0 +1,227 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Link-cut trees: a dynamic forest that, unlike UnionFind, can also split.
+//
+// Supports link, cut, connected, reroot and path aggregates (min / max / sum of
+// edge weights on the u-v path), all O(log n) amortized. Every node lives in
+// one flat vector and is addressed by index. Vertices are 0..n-1. Each edge is
+// a node of its own (taken from a free list), so an edge weight is just a node
+// value and a path aggregate is a splay-subtree aggregate. Vertex nodes carry
+// neutral values. cut(u, v) finds its edge node through per-vertex lists of
+// incident edges, intrusive and kept in flat arrays, so no operation allocates.
+
+struct PathAggregate {
+    long long minWeight, maxWeight, sum;
+    pair<int, int> minEdge, maxEdge;  // endpoints of the lightest / heaviest edge
+    int edges;
+};
+
+class LinkCutTree {
+   private:
+    struct Node {
+        int ch[2] = {-1, -1};
+        int p = -1;
+        bool rev = false;
+        long long weight = 0;
+        long long mn = LLONG_MAX, mx = LLONG_MIN, sum = 0;
+        int argMin = -1, argMax = -1, edges = 0;
+    };
+
+    int n;
+    vector<Node> t;
+    vector<int> freeEdges;
+    vector<pair<int, int>> endpoints;  // for edge nodes
+    // incident-edge lists: half-edge 2 * (e - n) + side is edge node e seen
+    // from endpoints[e].first (side 0) or .second (side 1)
+    vector<int> adjHead, adjNext, adjPrev;
+    vector<int> pathStack;
+
+    void addIncident(int x, int h) {
+        adjPrev[h] = -1;
+        adjNext[h] = adjHead[x];
+        if (adjHead[x] >= 0) adjPrev[adjHead[x]] = h;
+        adjHead[x] = h;
+    }
+
+    void removeIncident(int x, int h) {
+        (adjPrev[h] >= 0 ? adjNext[adjPrev[h]] : adjHead[x]) = adjNext[h];
+        if (adjNext[h] >= 0) adjPrev[adjNext[h]] = adjPrev[h];
+    }
+
+    // endpoint of half-edge h's edge on the far side from h's own vertex
+    int across(int h) const {
+        const pair<int, int>& ends = endpoints[n + h / 2];
+        return h & 1 ? ends.first : ends.second;
+    }
+
+    bool isEdge(int x) const { return x >= n; }
+
+    bool isRoot(int x) const {
+        int p = t[x].p;
+        return p < 0 || (t[p].ch[0] != x && t[p].ch[1] != x);
+    }
+
+    void pull(int x) {
+        Node& a = t[x];
+        if (isEdge(x)) {
+            a.mn = a.mx = a.sum = a.weight;
+            a.argMin = a.argMax = x;
+            a.edges = 1;
+        } else {
+            a.mn = LLONG_MAX;
+            a.mx = LLONG_MIN;
+            a.sum = 0;
+            a.argMin = a.argMax = -1;
+            a.edges = 0;
+        }
+        for (int c : a.ch) {
+            if (c < 0) continue;
+            const Node& b = t[c];
+            if (b.edges == 0) continue;
+            if (b.mn < a.mn) a.mn = b.mn, a.argMin = b.argMin;
+            if (b.mx > a.mx) a.mx = b.mx, a.argMax = b.argMax;
+            a.sum += b.sum;
+            a.edges += b.edges;
+        }
+    }
+
+    void push(int x) {
+        if (!t[x].rev) return;
+        swap(t[x].ch[0], t[x].ch[1]);
+        for (int c : t[x].ch) {
+            if (c >= 0) t[c].rev = !t[c].rev;
+        }
+        t[x].rev = false;
+    }
+
+    void rotate(int x) {
+        int p = t[x].p, g = t[p].p;
+        int dir = t[p].ch[1] == x;
+        if (!isRoot(p)) t[g].ch[t[g].ch[1] == p] = x;
+        t[x].p = g;
+        t[p].ch[dir] = t[x].ch[dir ^ 1];
+        if (t[p].ch[dir] >= 0) t[t[p].ch[dir]].p = p;
+        t[x].ch[dir ^ 1] = p;
+        t[p].p = x;
+        pull(p);
+        pull(x);
+    }
+
+    void splay(int x) {
+        // push pending reversals top-down without recursion
+        pathStack.clear();
+        for (int y = x;; y = t[y].p) {
+            pathStack.push_back(y);
+            if (isRoot(y)) break;
+        }
+        for (int i = (int)pathStack.size() - 1; i >= 0; i--) push(pathStack[i]);
+        while (!isRoot(x)) {
+            int p = t[x].p, g = t[p].p;
+            if (!isRoot(p)) rotate((t[g].ch[1] == p) == (t[p].ch[1] == x) ? p : x);
+            rotate(x);
+        }
+    }
+
+    void access(int x) {
+        for (int last = -1, y = x; y >= 0; last = y, y = t[y].p) {
+            splay(y);
+            t[y].ch[1] = last;
+            pull(y);
+        }
+        splay(x);
+    }
+
+    void attach(int x, int y) {
+        reroot(x);
+        t[x].p = y;
+    }
+
+    void detach(int x, int y) {
+        reroot(x);
+        access(y);
+        t[y].ch[0] = -1;
+        t[x].p = -1;
+        pull(y);
+    }
+
+   public:
+    LinkCutTree(int n) : n(n), t(2 * n), endpoints(2 * n), adjHead(n, -1), adjNext(2 * n), adjPrev(2 * n) {
+        for (int i = 0; i < 2 * n; i++) pull(i);
+        for (int e = 2 * n - 1; e >= n; e--) freeEdges.push_back(e);
+    }
+
+    int findRoot(int x) {
+        access(x);
+        while (true) {
+            push(x);
+            if (t[x].ch[0] < 0) break;
+            x = t[x].ch[0];
+        }
+        splay(x);
+        return x;
+    }
+
+    bool connected(int u, int v) { return u == v || findRoot(u) == findRoot(v); }
+
+    // make u the root of its tree
+    void reroot(int u) {
+        access(u);
+        t[u].rev = !t[u].rev;
+    }
+
+    // add edge (u, v) with weight w; false if u and v are already connected
+    bool link(int u, int v, long long w) {
+        if (connected(u, v)) return false;
+        int e = freeEdges.back();
+        freeEdges.pop_back();
+        t[e] = Node();
+        t[e].weight = w;
+        pull(e);
+        endpoints[e] = {u, v};
+        addIncident(u, 2 * (e - n));
+        addIncident(v, 2 * (e - n) + 1);
+        attach(u, e);
+        attach(e, v);
+        return true;
+    }
+
+    // remove edge (u, v); false if there is no such edge. Walks u's and v's
+    // incident edges in step, so finding it costs O(min(deg u, deg v))
+    bool cut(int u, int v) {
+        int hu = adjHead[u], hv = adjHead[v], h = -1;
+        while (h < 0 && (hu >= 0 || hv >= 0)) {
+            if (hu >= 0) {
+                if (across(hu) == v) h = hu;
+                hu = adjNext[hu];
+            }
+            if (hv >= 0) {
+                if (across(hv) == u) h = hv;
+                hv = adjNext[hv];
+            }
+        }
+        if (h < 0) return false;
+        int e = n + h / 2;
+        removeIncident(endpoints[e].first, 2 * (e - n));
+        removeIncident(endpoints[e].second, 2 * (e - n) + 1);
+        detach(endpoints[e].first, e);
+        detach(e, endpoints[e].second);
+        freeEdges.push_back(e);
+        return true;
+    }
+
+    // aggregate over the edges of the u-v path; false if not connected
+    bool pathQuery(int u, int v, PathAggregate& out) {
+        if (!connected(u, v)) return false;
+        reroot(u);
+        access(v);
+        const Node& a = t[v];
+        out.minWeight = a.mn;
+        out.maxWeight = a.mx;
+        out.sum = a.sum;
+        out.edges = a.edges;
+        out.minEdge = a.argMin >= 0 ? endpoints[a.argMin] : make_pair(-1, -1);
+        out.maxEdge = a.argMax >= 0 ? endpoints[a.argMax] : make_pair(-1, -1);
+        return true;
+    }
+};
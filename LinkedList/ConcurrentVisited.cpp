@@ -0,0 +1,254 @@
+#include <bits/stdc++.h>
+#include "SplitOrderedSet.cpp"
+using namespace std;
+
+// SplitOrderedSet.cpp as the visited set of a multi-threaded list algorithm:
+// a stress test against per-key bookkeeping, intersection detection over
+// many list pairs (detectintersectionUsingHashing from intersection.cpp, with
+// threads sharing one visited set), and the worst single insert while a set
+// grows, which is where a rehash-the-world table stalls.
+
+struct Node
+{
+    int data;
+    Node* next;
+    Node(int v)
+    {
+        data = v;
+        next = nullptr;
+    }
+};
+
+// threads hammer 4096 keys; every successful insert/remove is tallied per key,
+// so the final membership of each key is known exactly
+bool stress(int threads)
+{
+    const int KEYS = 4096, OPS = 200000;
+    SplitOrderedSet<int> set(2);
+    vector<vector<int>> net(threads, vector<int>(KEYS, 0));
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&, t]()
+        {
+            mt19937 rng(t + 1);
+            for (int i = 0; i < OPS; i++)
+            {
+                int k = rng() % KEYS;
+                int r = rng() % 3;
+                if(r == 0)
+                {
+                    net[t][k] += set.insert(k);
+                }
+                else if(r == 1)
+                {
+                    net[t][k] -= set.remove(k);
+                }
+                else
+                {
+                    set.contains(k);
+                }
+            }
+        });
+    }
+    for (auto& th : pool)
+    {
+        th.join();
+    }
+    size_t present = 0, visited = 0;
+    for (int k = 0; k < KEYS; k++)
+    {
+        int total = 0;
+        for (int t = 0; t < threads; t++)
+        {
+            total += net[t][k];
+        }
+        if(total != (int)set.contains(k) || total < 0 || total > 1)
+        {
+            return false;
+        }
+        present += total;
+    }
+    set.forEach([&](int)
+    {
+        visited++;
+    });
+    return present == set.size() && present == visited;
+}
+
+// group A: LISTS lists; B list i joins A list i at a random node, or (odd i) never
+struct Workload
+{
+    vector<Node*> a, b;
+    vector<Node*> expected;
+    vector<unique_ptr<Node>> nodes;
+
+    Workload(int lists, int length, mt19937& rng)
+    {
+        int value = 0;
+        auto make = [&](int len, Node* tailTarget)
+        {
+            Node* head = tailTarget;
+            for (int i = 0; i < len; i++)
+            {
+                nodes.emplace_back(new Node(value++));
+                nodes.back()->next = head;
+                head = nodes.back().get();
+            }
+            return head;
+        };
+        for (int i = 0; i < lists; i++)
+        {
+            a.push_back(make(length, nullptr));
+            Node* join = nullptr;
+            if(i % 2 == 0)
+            {
+                join = a[i];
+                for (int s = rng() % length; s > 0; s--)
+                {
+                    join = join->next;
+                }
+            }
+            expected.push_back(join);
+            b.push_back(make(length / 2, join));
+        }
+    }
+};
+
+template <class Insert, class Contains>
+vector<Node*> intersections(const Workload& w, int threads, Insert insert, Contains contains)
+{
+    vector<Node*> found(w.b.size(), nullptr);
+    atomic<size_t> next(0);
+    auto run = [&](auto phase)
+    {
+        next = 0;
+        vector<thread> pool;
+        for (int t = 0; t < threads; t++)
+        {
+            pool.emplace_back([&]()
+            {
+                for (size_t i; (i = next++) < w.a.size();)
+                {
+                    phase(i);
+                }
+            });
+        }
+        for (auto& th : pool)
+        {
+            th.join();
+        }
+    };
+    run([&](size_t i)
+    {
+        for (Node* p = w.a[i]; p != nullptr; p = p->next)
+        {
+            insert(p);
+        }
+    });
+    run([&](size_t i)
+    {
+        for (Node* p = w.b[i]; p != nullptr; p = p->next)
+        {
+            if(contains(p))
+            {
+                found[i] = p;
+                break;
+            }
+        }
+    });
+    return found;
+}
+
+void intersectionBenchmark(int threads)
+{
+    mt19937 rng(5);
+    Workload w(64, 1 << 15, rng);
+    cout << "Intersections of 64 list pairs (2^15 + 2^14 nodes each), visited sets of Node*:" << endl;
+    auto report = [&](const string& name, int t, auto body)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        vector<Node*> found = body();
+        auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+        cout << "  " << left << setw(34) << name + ", " + to_string(t) + " thread(s)" << right << setw(6) << ms
+             << " ms, " << (found == w.expected ? "correct" : "WRONG") << endl;
+    };
+
+    report("unordered_set", 1, [&]()
+    {
+        unordered_set<Node*> visited;
+        return intersections(w, 1, [&](Node* p)
+        {
+            visited.insert(p);
+        }, [&](Node* p)
+        {
+            return visited.count(p) > 0;
+        });
+    });
+    report("mutex + unordered_set", threads, [&]()
+    {
+        unordered_set<Node*> visited;
+        mutex lock;
+        return intersections(w, threads, [&](Node* p)
+        {
+            lock_guard<mutex> guard(lock);
+            visited.insert(p);
+        }, [&](Node* p)
+        {
+            lock_guard<mutex> guard(lock);
+            return visited.count(p) > 0;
+        });
+    });
+    for (int t : {1, threads})
+    {
+        report("SplitOrderedSet", t, [&]()
+        {
+            SplitOrderedSet<Node*> visited;
+            return intersections(w, t, [&](Node* p)
+            {
+                visited.insert(p);
+            }, [&](Node* p)
+            {
+                return visited.contains(p);
+            });
+        });
+        if(t == threads)
+        {
+            break;
+        }
+    }
+}
+
+// the slowest single insert while growing from empty to n elements
+template <class Set>
+long long worstInsertUs(Set& set, int n)
+{
+    long long worst = 0;
+    for (int i = 0; i < n; i++)
+    {
+        auto start = chrono::steady_clock::now();
+        set.insert(i);
+        worst = max(worst, (long long)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+    }
+    return worst;
+}
+
+int main()
+{
+    int threads = max(4u, thread::hardware_concurrency());
+    cout << "Stress, " << threads << " threads x 200000 random insert/remove/contains on 4096 keys: "
+         << (stress(threads) ? "consistent" : "INCONSISTENT") << endl
+         << endl;
+
+    intersectionBenchmark(threads);
+
+    const int n = 1 << 22;
+    unordered_set<int> table;
+    SplitOrderedSet<int> split;
+    long long tableWorst = worstInsertUs(table, n);
+    long long splitWorst = worstInsertUs(split, n);
+    cout << endl
+         << "Worst single insert growing to 2^22 elements: unordered_set " << tableWorst << " us, SplitOrderedSet "
+         << splitWorst << " us (" << split.buckets() << " buckets)" << endl;
+    return 0;
+}
@@ -0,0 +1,420 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Intrusive linked lists: the links live inside the user's objects, so
+// putting an object on a list allocates nothing and reaching the object from
+// its link is a cast, not another pointer hop.
+//
+// A type joins one list per hook it inherits. The tag type tells the hooks
+// apart, so one object can sit on several lists at once:
+//
+//     struct Pending {};
+//     struct ByCustomer {};
+//     struct Order : SListHook<Pending>, DListHook<ByCustomer> { ... };
+//     SList<Order, Pending> pending;
+//     DList<Order, ByCustomer> customerOrders;
+//
+// The lists never own their elements: whoever created an object destroys it.
+// Copying an object does not copy its links (the copy starts unlinked).
+// A DListHook unlinks itself when its object is destroyed. An SListHook
+// cannot do that in O(1), so an object must be off its singly linked lists
+// before it goes away.
+//
+// The algorithms of Reverse.cpp, CycleDetection.cpp and intersection.cpp work
+// on raw hook chains (reverseChain, findCycleStart, findIntersection), so they
+// also apply to chains built or damaged outside SList, e.g. two lists that
+// share a suffix.
+
+template <class Tag>
+struct SListHook
+{
+    SListHook* next = nullptr;
+
+    SListHook() {}
+    SListHook(const SListHook&) {}
+    SListHook& operator=(const SListHook&) { return *this; }
+};
+
+template <class Tag>
+struct DListHook
+{
+    DListHook* prev = nullptr;
+    DListHook* next = nullptr;
+
+    DListHook() {}
+    DListHook(const DListHook&) {}
+    DListHook& operator=(const DListHook&) { return *this; }
+    ~DListHook() { unlink(); }
+
+    bool linked() const { return next != nullptr; }
+
+    void unlink()
+    {
+        if(!linked())
+        {
+            return;
+        }
+        prev->next = next;
+        next->prev = prev;
+        prev = next = nullptr;
+    }
+
+    // link this (unlinked) hook in front of pos
+    void linkBefore(DListHook* pos)
+    {
+        next = pos;
+        prev = pos->prev;
+        prev->next = this;
+        pos->prev = this;
+    }
+};
+
+// Reverse.cpp on hooks; returns the new head
+template <class Tag>
+SListHook<Tag>* reverseChain(SListHook<Tag>* head)
+{
+    SListHook<Tag>* prev = nullptr;
+    SListHook<Tag>* curr = head;
+    while(curr != nullptr)
+    {
+        SListHook<Tag>* next = curr->next;
+        curr->next = prev;
+        prev = curr;
+        curr = next;
+    }
+    return prev;
+}
+
+// Floyd's tortoise and hare; the first hook of the cycle, or nullptr
+template <class Tag>
+SListHook<Tag>* findCycleStart(SListHook<Tag>* head)
+{
+    SListHook<Tag>* slow = head;
+    SListHook<Tag>* fast = head;
+    while(fast != nullptr && fast->next != nullptr)
+    {
+        slow = slow->next;
+        fast = fast->next->next;
+        if(slow == fast)
+        {
+            slow = head;
+            while(slow != fast)
+            {
+                slow = slow->next;
+                fast = fast->next;
+            }
+            return slow;
+        }
+    }
+    return nullptr;
+}
+
+// first hook shared by two acyclic chains, or nullptr; O(1) extra space
+template <class Tag>
+SListHook<Tag>* findIntersection(SListHook<Tag>* a, SListHook<Tag>* b)
+{
+    auto length = [](SListHook<Tag>* p)
+    {
+        size_t len = 0;
+        for (; p != nullptr; p = p->next)
+        {
+            len++;
+        }
+        return len;
+    };
+    size_t la = length(a), lb = length(b);
+    for (; la > lb; la--)
+    {
+        a = a->next;
+    }
+    for (; lb > la; lb--)
+    {
+        b = b->next;
+    }
+    while(a != b)
+    {
+        a = a->next;
+        b = b->next;
+    }
+    return a;
+}
+
+// Singly linked, with a tail pointer so that pushBack and splice are O(1).
+template <class T, class Tag>
+class SList
+{
+    typedef SListHook<Tag> Hook;
+
+    Hook* head = nullptr;
+    Hook* tail = nullptr;
+
+public:
+    class iterator
+    {
+        Hook* at;
+
+    public:
+        iterator(Hook* h) : at(h) {}
+        T& operator*() const { return *static_cast<T*>(at); }
+        T* operator->() const { return static_cast<T*>(at); }
+        iterator& operator++()
+        {
+            at = at->next;
+            return *this;
+        }
+        bool operator!=(const iterator& o) const { return at != o.at; }
+    };
+
+    SList() {}
+    SList(const SList&) = delete;
+    SList& operator=(const SList&) = delete;
+
+    static Hook* hook(T& x) { return static_cast<Hook*>(&x); }
+    static T& owner(Hook* h) { return *static_cast<T*>(h); }
+
+    iterator begin() const { return iterator(head); }
+    iterator end() const { return iterator(nullptr); }
+    bool empty() const { return head == nullptr; }
+    T& front() const { return owner(head); }
+    T& back() const { return owner(tail); }
+    Hook* firstHook() const { return head; }
+
+    void pushFront(T& x)
+    {
+        Hook* h = hook(x);
+        h->next = head;
+        head = h;
+        if(tail == nullptr)
+        {
+            tail = h;
+        }
+    }
+
+    void pushBack(T& x)
+    {
+        Hook* h = hook(x);
+        h->next = nullptr;
+        if(tail != nullptr)
+        {
+            tail->next = h;
+        }
+        else
+        {
+            head = h;
+        }
+        tail = h;
+    }
+
+    T& popFront()
+    {
+        Hook* h = head;
+        head = h->next;
+        if(head == nullptr)
+        {
+            tail = nullptr;
+        }
+        h->next = nullptr;
+        return owner(h);
+    }
+
+    // O(n): a singly linked hook does not know its predecessor
+    bool remove(T& x)
+    {
+        Hook* h = hook(x);
+        Hook* prev = nullptr;
+        for (Hook* p = head; p != nullptr; prev = p, p = p->next)
+        {
+            if(p != h)
+            {
+                continue;
+            }
+            (prev != nullptr ? prev->next : head) = p->next;
+            if(tail == p)
+            {
+                tail = prev;
+            }
+            p->next = nullptr;
+            return true;
+        }
+        return false;
+    }
+
+    void reverse()
+    {
+        tail = head;
+        head = reverseChain(head);
+    }
+
+    // moves all of other's elements to the end of this list in O(1)
+    void splice(SList& other)
+    {
+        if(other.empty())
+        {
+            return;
+        }
+        if(tail != nullptr)
+        {
+            tail->next = other.head;
+        }
+        else
+        {
+            head = other.head;
+        }
+        tail = other.tail;
+        other.head = other.tail = nullptr;
+    }
+
+    // unlinks every element, leaving each hook ready for reuse
+    void clear()
+    {
+        while(!empty())
+        {
+            popFront();
+        }
+    }
+
+    size_t size() const
+    {
+        size_t n = 0;
+        for (Hook* p = head; p != nullptr; p = p->next)
+        {
+            n++;
+        }
+        return n;
+    }
+
+    bool hasCycle() const { return findCycleStart(head) != nullptr; }
+};
+
+// Doubly linked and circular around a sentinel hook, so insert, erase and
+// splice are O(1) and never special-case the ends.
+template <class T, class Tag>
+class DList
+{
+    typedef DListHook<Tag> Hook;
+
+    Hook sentinel;
+
+public:
+    class iterator
+    {
+        Hook* at;
+
+    public:
+        iterator(Hook* h) : at(h) {}
+        T& operator*() const { return *static_cast<T*>(at); }
+        T* operator->() const { return static_cast<T*>(at); }
+        iterator& operator++()
+        {
+            at = at->next;
+            return *this;
+        }
+        iterator& operator--()
+        {
+            at = at->prev;
+            return *this;
+        }
+        bool operator!=(const iterator& o) const { return at != o.at; }
+        Hook* hook() const { return at; }
+    };
+
+    DList() { sentinel.prev = sentinel.next = &sentinel; }
+    DList(const DList&) = delete;
+    DList& operator=(const DList&) = delete;
+    ~DList() { clear(); }
+
+    static Hook* hook(T& x) { return static_cast<Hook*>(&x); }
+    static T& owner(Hook* h) { return *static_cast<T*>(h); }
+    static bool contains(T& x) { return hook(x)->linked(); }
+
+    iterator begin() { return iterator(sentinel.next); }
+    iterator end() { return iterator(&sentinel); }
+    bool empty() const { return sentinel.next == &sentinel; }
+    T& front() { return owner(sentinel.next); }
+    T& back() { return owner(sentinel.prev); }
+
+    // x must not be on another list of this tag; unlink it first
+    void insert(iterator pos, T& x) { hook(x)->linkBefore(pos.hook()); }
+    void pushFront(T& x) { hook(x)->linkBefore(sentinel.next); }
+    void pushBack(T& x) { hook(x)->linkBefore(&sentinel); }
+    static void erase(T& x) { hook(x)->unlink(); }
+
+    T& popFront()
+    {
+        T& x = front();
+        erase(x);
+        return x;
+    }
+
+    // moves x (from any list of this tag, or none) in front of pos
+    void moveBefore(iterator pos, T& x)
+    {
+        if(hook(x) == pos.hook())
+        {
+            return;
+        }
+        erase(x);
+        insert(pos, x);
+    }
+
+    // moves all of other's elements in front of pos in O(1)
+    void splice(iterator pos, DList& other)
+    {
+        if(other.empty())
+        {
+            return;
+        }
+        Hook* first = other.sentinel.next;
+        Hook* last = other.sentinel.prev;
+        other.sentinel.prev = other.sentinel.next = &other.sentinel;
+        Hook* at = pos.hook();
+        first->prev = at->prev;
+        at->prev->next = first;
+        last->next = at;
+        at->prev = last;
+    }
+
+    // swaps prev and next on every hook, sentinel included
+    void reverse()
+    {
+        Hook* h = &sentinel;
+        do
+        {
+            swap(h->prev, h->next);
+            h = h->prev;
+        } while(h != &sentinel);
+    }
+
+    void clear()
+    {
+        while(!empty())
+        {
+            sentinel.next->unlink();
+        }
+    }
+
+    size_t size() const
+    {
+        size_t n = 0;
+        for (const Hook* p = sentinel.next; p != &sentinel; p = p->next)
+        {
+            n++;
+        }
+        return n;
+    }
+
+    // every next/prev pair agrees; a broken chain shows up here instead of as a hang
+    bool consistent() const
+    {
+        const Hook* p = &sentinel;
+        do
+        {
+            if(p->next == nullptr || p->next->prev != p)
+            {
+                return false;
+            }
+            p = p->next;
+        } while(p != &sentinel);
+        return true;
+    }
+};
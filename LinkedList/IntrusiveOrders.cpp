@@ -0,0 +1,190 @@
+#include <bits/stdc++.h>
+#include "IntrusiveList.cpp"
+using namespace std;
+
+// Orders that sit on three lists at once through IntrusiveList.cpp hooks: a
+// singly linked pending queue, a per-customer list and a recently-used list.
+// Then the Reverse / cycle / intersection / splice operations on hooks, and
+// a traversal of intrusive links against the Node-of-pointers list that the
+// same membership costs without hooks.
+
+struct Pending {};
+struct ByCustomer {};
+struct Recent {};
+
+struct Order : SListHook<Pending>, DListHook<ByCustomer>, DListHook<Recent>
+{
+    int id;
+    int customer;
+    long long cents;
+    Order(int id, int customer, long long cents) : id(id), customer(customer), cents(cents) {}
+};
+
+typedef SList<Order, Pending> PendingList;
+typedef DList<Order, ByCustomer> CustomerList;
+typedef DList<Order, Recent> RecentList;
+
+template <class List>
+void print(const string& label, List& list)
+{
+    cout << label << ":";
+    for (Order& o : list)
+    {
+        cout << " " << o.id;
+    }
+    cout << endl;
+}
+
+// the same membership without hooks: one extra node per element, one extra hop per visit
+struct Node
+{
+    Order* order;
+    Node* next;
+    Node(Order* o)
+    {
+        order = o;
+        next = nullptr;
+    }
+};
+
+void walkthrough()
+{
+    vector<Order> orders;
+    for (int i = 0; i < 8; i++)
+    {
+        orders.emplace_back(i, i % 3, 100 * (i + 1));
+    }
+
+    PendingList pending;
+    CustomerList byCustomer[3];
+    RecentList recent;
+    for (Order& o : orders)
+    {
+        pending.pushBack(o);
+        byCustomer[o.customer].pushBack(o);
+        recent.pushFront(o);
+    }
+    print("pending", pending);
+    print("customer 1", byCustomer[1]);
+    print("recent", recent);
+
+    // touching an order moves it to the front of the recent list: no allocation, O(1)
+    recent.moveBefore(recent.begin(), orders[2]);
+    print("recent after touching 2", recent);
+
+    // customer 1 merges into customer 0; order 4 is cancelled
+    byCustomer[0].splice(byCustomer[0].end(), byCustomer[1]);
+    CustomerList::erase(orders[4]);
+    RecentList::erase(orders[4]);
+    print("customer 0 after merge and cancel", byCustomer[0]);
+    cout << "customer 1 empty: " << byCustomer[1].empty() << ", order 4 still on recent: "
+         << RecentList::contains(orders[4]) << endl;
+
+    pending.reverse();
+    print("pending reversed", pending);
+    byCustomer[0].reverse();
+    print("customer 0 reversed", byCustomer[0]);
+
+    // a second pending queue that shares a suffix with the first (as in intersection.cpp)
+    vector<Order> extra;
+    extra.emplace_back(100, 0, 1);
+    extra.emplace_back(101, 0, 1);
+    SListHook<Pending>* a = pending.firstHook();
+    SListHook<Pending>* b = &extra[0];
+    extra[0].SListHook<Pending>::next = &extra[1];
+    extra[1].SListHook<Pending>::next = a->next->next->next;  // join at the fourth pending order
+    SListHook<Pending>* meet = findIntersection(a, b);
+    cout << "shared suffix starts at order " << PendingList::owner(meet).id << endl;
+
+    // a stray link closes a cycle (as in CycleDetection.cpp)
+    SListHook<Pending>* last = a;
+    while(last->next != nullptr)
+    {
+        last = last->next;
+    }
+    last->next = a->next->next;
+    SListHook<Pending>* start = findCycleStart(a);
+    cout << "cycle starts at order " << (start ? PendingList::owner(start).id : -1) << endl;
+    last->next = nullptr;
+    cout << "after removing it, hasCycle = " << pending.hasCycle() << endl;
+
+    Order late(8, 2, 900);
+    PendingList later;
+    later.pushBack(late);
+    pending.splice(later);
+    print("pending after splicing in [8]", pending);
+    cout << "lists consistent: " << (byCustomer[0].consistent() && recent.consistent()) << endl;
+    pending.clear();
+}
+
+void traversal()
+{
+    const int n = 1 << 20;
+    mt19937 rng(3);
+    vector<Order> orders;
+    orders.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        orders.emplace_back(i, rng() % 1000, rng() % 100000);
+    }
+    vector<int> sequence(n);
+    iota(sequence.begin(), sequence.end(), 0);
+    shuffle(sequence.begin(), sequence.end(), rng);
+
+    auto start = chrono::high_resolution_clock::now();
+    PendingList intrusive;
+    for (int i : sequence)
+    {
+        intrusive.pushBack(orders[i]);
+    }
+    auto built = chrono::high_resolution_clock::now();
+    long long sum1 = 0;
+    for (Order& o : intrusive)
+    {
+        sum1 += o.cents;
+    }
+    auto end = chrono::high_resolution_clock::now();
+    cout << "intrusive:         build " << chrono::duration_cast<chrono::microseconds>(built - start).count()
+         << " us (0 allocations), walk " << chrono::duration_cast<chrono::microseconds>(end - built).count()
+         << " us" << endl;
+
+    // each order's node is allocated when the order is, then linked in queue order
+    start = chrono::high_resolution_clock::now();
+    vector<Node*> nodes(n);
+    for (int i = 0; i < n; i++)
+    {
+        nodes[i] = new Node(&orders[i]);
+    }
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    for (int i : sequence)
+    {
+        (tail != nullptr ? tail->next : head) = nodes[i];
+        tail = nodes[i];
+    }
+    built = chrono::high_resolution_clock::now();
+    long long sum2 = 0;
+    for (Node* p = head; p != nullptr; p = p->next)
+    {
+        sum2 += p->order->cents;
+    }
+    end = chrono::high_resolution_clock::now();
+    cout << "Node of pointers:  build " << chrono::duration_cast<chrono::microseconds>(built - start).count()
+         << " us (" << n << " allocations), walk "
+         << chrono::duration_cast<chrono::microseconds>(end - built).count() << " us"
+         << (sum1 == sum2 ? "" : " (SUMS DIFFER)") << endl;
+
+    for (Node* node : nodes)
+    {
+        delete node;
+    }
+    intrusive.clear();
+}
+
+int main()
+{
+    walkthrough();
+    cout << endl << "2^20 orders in shuffled order:" << endl;
+    traversal();
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include <bits/stdc++.h>
+#include "SelfOrganizingList.cpp"
+using namespace std;
+
+// Zipf-distributed lookups on 8..256 keys: the static Node list (one heap
+// node per key, as in Reverse.cpp), the self-organizing list under each
+// policy, and an open-addressing flat hash. Reports ns per lookup and, for
+// the lists, the mean search length (keys compared per lookup).
+//
+// Popular keys are inserted at random positions, so a static list finds
+// them only as fast as the insertion order happens to allow.
+
+struct Node
+{
+    int data;
+    int value;
+    Node* next;
+    Node(int k, int v)
+    {
+        data = k;
+        value = v;
+        next = nullptr;
+    }
+};
+
+// linear probing, power-of-two table at load <= 1/2; key -1 = empty
+class FlatHash
+{
+    vector<int> keys, values;
+    int mask;
+
+public:
+    FlatHash(int n)
+    {
+        int size = 1;
+        while(size < 2 * n)
+        {
+            size <<= 1;
+        }
+        keys.assign(size, -1);
+        values.assign(size, 0);
+        mask = size - 1;
+    }
+
+    static unsigned slot(int key) { return (unsigned)key * 0x9E3779B1u; }
+
+    void insert(int key, int value)
+    {
+        unsigned i = slot(key) & mask;
+        while(keys[i] != -1)
+        {
+            i = (i + 1) & mask;
+        }
+        keys[i] = key;
+        values[i] = value;
+    }
+
+    int* find(int key)
+    {
+        for (unsigned i = slot(key) & mask; keys[i] != -1; i = (i + 1) & mask)
+        {
+            if(keys[i] == key)
+            {
+                return &values[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+// ranks 0..n-1 with P(rank r) proportional to 1 / (r + 1)^s
+vector<int> zipfRanks(int n, double s, int draws, mt19937& rng)
+{
+    vector<double> cdf(n);
+    double total = 0;
+    for (int r = 0; r < n; r++)
+    {
+        total += 1.0 / pow(r + 1, s);
+        cdf[r] = total;
+    }
+    uniform_real_distribution<double> u(0, total);
+    vector<int> out(draws);
+    for (int& x : out)
+    {
+        x = min(n - 1, (int)(lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin()));
+    }
+    return out;
+}
+
+template <class F>
+double nsPerLookup(const vector<int>& lookups, F lookup)
+{
+    long long sink = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (int key : lookups)
+    {
+        sink += lookup(key);
+    }
+    double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - start).count() / lookups.size();
+    if(sink == 42)
+    {
+        cout << endl;
+    }
+    return ns;
+}
+
+template <OrganizePolicy P>
+void runList(const char* name, const vector<int>& keys, const vector<int>& lookups, long long expectSum)
+{
+    SelfOrganizingList<int, int, P> list(keys.size());
+    for (int k : keys)
+    {
+        list.insert(k, k ^ 0x5555);
+    }
+    long long sum = 0;
+    double ns = nsPerLookup(lookups, [&](int key)
+    {
+        int v = *list.find(key);
+        sum += v;
+        return v;
+    });
+    cout << "  " << left << setw(15) << name << right << fixed << setprecision(1) << setw(7) << ns << " ns"
+         << setw(8) << (double)list.probes / lookups.size() << (sum == expectSum ? "" : "  WRONG VALUES") << endl;
+}
+
+void benchmark(int n, double s, mt19937& rng)
+{
+    const int LOOKUPS = 1 << 21;
+    vector<int> keys(n);
+    for (int& k : keys)
+    {
+        k = rng() & 0x3FFFFFFF;
+    }
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    n = keys.size();
+    shuffle(keys.begin(), keys.end(), rng);
+
+    // rank r is keys[popular[r]], so popularity is unrelated to insertion order
+    vector<int> popular(n);
+    iota(popular.begin(), popular.end(), 0);
+    shuffle(popular.begin(), popular.end(), rng);
+    vector<int> lookups = zipfRanks(n, s, LOOKUPS, rng);
+    long long expectSum = 0;
+    for (int& x : lookups)
+    {
+        x = keys[popular[x]];
+        expectSum += x ^ 0x5555;
+    }
+
+    cout << n << " keys, Zipf s = " << s << "   (ns/lookup, keys compared/lookup)" << endl;
+
+    Node* head = nullptr;
+    for (int i = n - 1; i >= 0; i--)
+    {
+        Node* node = new Node(keys[i], keys[i] ^ 0x5555);
+        node->next = head;
+        head = node;
+    }
+    unsigned long long probes = 0;
+    double ns = nsPerLookup(lookups, [&](int key)
+    {
+        Node* p = head;
+        while(++probes, p->data != key)
+        {
+            p = p->next;
+        }
+        return p->value;
+    });
+    cout << "  " << left << setw(15) << "Node list" << right << fixed << setprecision(1) << setw(7) << ns << " ns"
+         << setw(8) << (double)probes / lookups.size() << endl;
+    while(head != nullptr)
+    {
+        Node* next = head->next;
+        delete head;
+        head = next;
+    }
+
+    runList<STATIC>("static arena", keys, lookups, expectSum);
+    runList<MOVE_TO_FRONT>("move-to-front", keys, lookups, expectSum);
+    runList<TRANSPOSE>("transpose", keys, lookups, expectSum);
+    runList<COUNT>("count", keys, lookups, expectSum);
+
+    FlatHash hash(n);
+    for (int k : keys)
+    {
+        hash.insert(k, k ^ 0x5555);
+    }
+    ns = nsPerLookup(lookups, [&](int key)
+    {
+        return *hash.find(key);
+    });
+    cout << "  " << left << setw(15) << "flat hash" << right << fixed << setprecision(1) << setw(7) << ns << " ns"
+         << endl;
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+}
+
+// the eviction and erase paths against a map, since the benchmark only hits
+bool crossCheck(mt19937& rng)
+{
+    SelfOrganizingList<int, int, MOVE_TO_FRONT> mtf(16);
+    SelfOrganizingList<int, int, TRANSPOSE> tr(16);
+    SelfOrganizingList<int, int, COUNT> cnt(16);
+    auto check = [&](auto& list)
+    {
+        map<int, int> present;
+        list.forEach([&](int k, int v)
+        {
+            present[k] = v;
+        });
+        if((int)present.size() != list.size())
+        {
+            return false;
+        }
+        for (int op = 0; op < 200000; op++)
+        {
+            if(op % 1000 == 0 && !list.consistent())
+            {
+                return false;
+            }
+            int k = rng() % 40;
+            int r = rng() % 10;
+            if(r < 6)
+            {
+                int* v = list.find(k);
+                if((v != nullptr) != (present.count(k) > 0) || (v && *v != present[k]))
+                {
+                    return false;
+                }
+            }
+            else if(r < 8)
+            {
+                if(list.erase(k) != (present.erase(k) > 0))
+                {
+                    return false;
+                }
+            }
+            else if(!present.count(k))
+            {
+                if(list.size() == list.capacity())
+                {
+                    // the victim is whatever the list holds last
+                    int last = -1;
+                    list.forEach([&](int key, int)
+                    {
+                        last = key;
+                    });
+                    present.erase(last);
+                }
+                list.insert(k, op);
+                present[k] = op;
+            }
+        }
+        return list.consistent();
+    };
+    return check(mtf) && check(tr) && check(cnt);
+}
+
+int main()
+{
+    mt19937 rng(99);
+    cout << "insert/find/erase/evict against a map: " << (crossCheck(rng) ? "agree" : "DISAGREE") << endl << endl;
+    for (double s : {1.0, 1.5})
+    {
+        for (int n : {8, 16, 64, 256})
+        {
+            benchmark(n, s, rng);
+        }
+    }
+    return 0;
+}
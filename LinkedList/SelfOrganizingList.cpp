@@ -0,0 +1,246 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Self-organizing list: a short key -> value list that moves hits toward the
+// front, so under skewed (e.g. Zipf) lookups the expected search length
+// tracks the popular keys, not the list length.
+//
+//   MOVE_TO_FRONT  a hit moves to the head
+//   TRANSPOSE      a hit swaps with its predecessor
+//   COUNT          a hit bumps an 8-bit counter; the list stays sorted by
+//                  counter, highest first, and a hit jumps to the front of
+//                  its old count group, which keeps the order. When a counter
+//                  would pass 255 every counter is halved, which also lets
+//                  the order follow a shifting workload.
+//   STATIC         never reorders (the baseline)
+//
+// Entries live in a fixed arena of `capacity` slots linked by index in both
+// directions, so a promotion is O(1) and nothing is allocated after
+// construction. Inserting into a full list replaces the last entry, the one
+// the policy ranks lowest, which is what a per-bucket cache list wants.
+// COUNT's halving pass is O(n), but it runs at most once per 128 hits.
+
+enum OrganizePolicy { MOVE_TO_FRONT, TRANSPOSE, COUNT, STATIC };
+
+template <class Key, class Value, OrganizePolicy P>
+class SelfOrganizingList
+{
+    vector<Key> keys;
+    vector<Value> values;
+    vector<int> next, prev;  // -1 = none
+    vector<uint8_t> count;
+    array<int, 256> groupFirst;  // COUNT: first slot holding each counter value, or -1
+    int head = -1, tail = -1, freeList = 0, used = 0;
+
+    void unlink(int x)
+    {
+        (prev[x] >= 0 ? next[prev[x]] : head) = next[x];
+        (next[x] >= 0 ? prev[next[x]] : tail) = prev[x];
+    }
+
+    // links x in front of pos; pos == -1 appends
+    void linkBefore(int x, int pos)
+    {
+        next[x] = pos;
+        prev[x] = pos >= 0 ? prev[pos] : tail;
+        (prev[x] >= 0 ? next[prev[x]] : head) = x;
+        (pos >= 0 ? prev[pos] : tail) = x;
+    }
+
+    // x leaves its count group; the group's first slot moves on if x was it
+    void leaveGroup(int x)
+    {
+        int c = count[x];
+        if(groupFirst[c] == x)
+        {
+            groupFirst[c] = next[x] >= 0 && count[next[x]] == c ? next[x] : -1;
+        }
+    }
+
+    void halveCounts()
+    {
+        groupFirst.fill(-1);
+        for (int i = head; i >= 0; i = next[i])
+        {
+            count[i] >>= 1;
+            if(groupFirst[count[i]] < 0)
+            {
+                groupFirst[count[i]] = i;
+            }
+        }
+    }
+
+    void promote(int x)
+    {
+        if constexpr (P == MOVE_TO_FRONT)
+        {
+            if(x != head)
+            {
+                unlink(x);
+                linkBefore(x, head);
+            }
+        }
+        else if constexpr (P == TRANSPOSE)
+        {
+            int p = prev[x];
+            if(p >= 0)
+            {
+                unlink(x);
+                linkBefore(x, p);
+            }
+        }
+        else if constexpr (P == COUNT)
+        {
+            if(count[x] == 255)
+            {
+                halveCounts();
+            }
+            int c = count[x];
+            int first = groupFirst[c];
+            leaveGroup(x);
+            if(first != x)
+            {
+                unlink(x);
+                linkBefore(x, first);
+            }
+            // x now sits right after the last slot counting c + 1 or more
+            count[x] = c + 1;
+            if(groupFirst[c + 1] < 0)
+            {
+                groupFirst[c + 1] = x;
+            }
+        }
+    }
+
+public:
+    // probes (key comparisons) made by find, for measuring search length
+    unsigned long long probes = 0;
+
+    SelfOrganizingList(int capacity)
+        : keys(capacity), values(capacity), next(capacity), prev(capacity, -1), count(capacity, 0)
+    {
+        if(capacity <= 0)
+        {
+            throw invalid_argument("capacity must be positive");
+        }
+        for (int i = 0; i < capacity; i++)
+        {
+            next[i] = i + 1 < capacity ? i + 1 : -1;
+        }
+        groupFirst.fill(-1);
+    }
+
+    int size() const { return used; }
+    int capacity() const { return keys.size(); }
+
+    // the value for key, promoted per the policy, or nullptr
+    Value* find(const Key& key)
+    {
+        unsigned long long steps = 0;
+        for (int i = head; i >= 0; i = next[i])
+        {
+            steps++;
+            if(keys[i] == key)
+            {
+                probes += steps;
+                promote(i);
+                return &values[i];
+            }
+        }
+        probes += steps;
+        return nullptr;
+    }
+
+    // inserts a key that is not present; when full, the last entry is replaced
+    void insert(const Key& key, const Value& value)
+    {
+        int x;
+        if(freeList >= 0)
+        {
+            x = freeList;
+            freeList = next[x];
+            used++;
+        }
+        else
+        {
+            x = tail;
+            if constexpr (P == COUNT)
+            {
+                leaveGroup(x);
+            }
+            unlink(x);
+        }
+        keys[x] = key;
+        values[x] = value;
+        count[x] = 0;
+        if constexpr (P == MOVE_TO_FRONT)
+        {
+            linkBefore(x, head);
+        }
+        else
+        {
+            // new entries start last: counter 0 sorts after every other counter
+            linkBefore(x, -1);
+            if(P == COUNT && groupFirst[0] < 0)
+            {
+                groupFirst[0] = x;
+            }
+        }
+    }
+
+    bool erase(const Key& key)
+    {
+        for (int i = head; i >= 0; i = next[i])
+        {
+            if(keys[i] != key)
+            {
+                continue;
+            }
+            if constexpr (P == COUNT)
+            {
+                leaveGroup(i);
+            }
+            unlink(i);
+            next[i] = freeList;
+            freeList = i;
+            used--;
+            return true;
+        }
+        return false;
+    }
+
+    // links agree in both directions; for COUNT also that counters never rise
+    // along the list and groupFirst points at the first slot of each group
+    bool consistent() const
+    {
+        int seen = 0, last = -1;
+        array<int, 256> first;
+        first.fill(-1);
+        for (int i = head; i >= 0; last = i, i = next[i])
+        {
+            if(prev[i] != last || ++seen > used)
+            {
+                return false;
+            }
+            if(P == COUNT && last >= 0 && count[i] > count[last])
+            {
+                return false;
+            }
+            if(first[count[i]] < 0)
+            {
+                first[count[i]] = i;
+            }
+        }
+        return seen == used && tail == last && (P != COUNT || first == groupFirst);
+    }
+
+    // keys from head to tail
+    template <class F>
+    void forEach(F f) const
+    {
+        for (int i = head; i >= 0; i = next[i])
+        {
+            f(keys[i], values[i]);
+        }
+    }
+};
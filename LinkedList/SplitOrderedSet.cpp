@@ -0,0 +1,346 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Lock-free resizable hash set: Shalev and Shavit's split-ordered list on
+// top of Michael's lock-free sorted linked list.
+//
+// Every element lives in ONE sorted lock-free list. It is ordered by the
+// bit-reversed hash, so the elements of bucket b (hash mod 2^k) are
+// contiguous, and doubling the table splits each bucket's run in two without
+// moving anything. A bucket is just a pointer to a dummy node that marks
+// where its run starts:
+//   regular node  splitKey = reverse(hash | 2^63)   (odd)
+//   dummy node    splitKey = reverse(bucket)        (even, sorts first)
+// Growing the table only bumps bucketCount. A bucket's dummy is inserted on
+// first use, after its parent bucket's (b with the top bit cleared), so the
+// cost of growth is spread over later operations. Nothing rehashes the world.
+//
+// Bucket pointers sit in segments of doubling size (segment s holds buckets
+// [2^s, 2^(s+1)), segment 0 holds 0 and 1), allocated on first touch, so the
+// directory never moves either.
+//
+// Deletion marks the victim's next pointer (bit 0), then unlinks it. Any
+// traversal that meets a marked node helps unlink it. The thread whose CAS
+// unlinks a node retires it. Retired nodes are only freed by reclaim() or the
+// destructor, which must run while no other thread uses the set. That keeps
+// traversals safe (no node is freed under a reader) and rules out ABA, at
+// the cost of holding removed nodes until a quiescent point, e.g. between
+// phases of a parallel algorithm.
+//
+// Key needs ==, operator< (only to order full 64-bit hash collisions) and a
+// Hash; hashes are run through a 64-bit finalizer, so identity hashes such as
+// std::hash<T*> are fine.
+
+template <class Key, class Hash = hash<Key>>
+class SplitOrderedSet
+{
+    struct SetNode
+    {
+        uint64_t splitKey;
+        Key key;
+        atomic<uintptr_t> next;  // successor | 1 if this node is deleted
+        SetNode* retiredNext = nullptr;
+
+        SetNode(uint64_t s, const Key& k) : splitKey(s), key(k), next(0) {}
+    };
+
+    static_assert(atomic<SetNode*>::is_always_lock_free && sizeof(atomic<SetNode*>) == sizeof(SetNode*),
+                  "bucket slots are zero-filled raw memory");
+    static const int SEGMENTS = 48;
+    static const uintptr_t MARK = 1;
+
+    atomic<atomic<SetNode*>*> segments[SEGMENTS];
+    atomic<size_t> bucketCount;
+    atomic<size_t> elements;
+    atomic<SetNode*> retired;
+    SetNode* head;  // dummy of bucket 0, the start of the whole list
+    Hash hasher;
+    double maxLoad;
+
+    static SetNode* ptr(uintptr_t x) { return reinterpret_cast<SetNode*>(x & ~MARK); }
+    static bool marked(uintptr_t x) { return x & MARK; }
+
+    static uint64_t reverseBits(uint64_t x)
+    {
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        return __builtin_bswap64(x);
+    }
+
+    uint64_t hashOf(const Key& key) const
+    {
+        uint64_t z = (uint64_t)hasher(key) + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static uint64_t regularKey(uint64_t h) { return reverseBits(h | (1ULL << 63)); }
+    static uint64_t dummyKey(uint64_t bucket) { return reverseBits(bucket); }
+
+    // the bucket's slot in its segment, allocating the segment on first touch
+    atomic<SetNode*>& slot(size_t bucket)
+    {
+        int s = bucket < 2 ? 0 : 63 - __builtin_clzll(bucket);
+        size_t base = s == 0 ? 0 : (size_t)1 << s;
+        size_t size = s == 0 ? 2 : (size_t)1 << s;
+        atomic<SetNode*>* segment = segments[s].load(memory_order_acquire);
+        if(segment == nullptr)
+        {
+            // calloc: a big segment comes back as untouched zero pages, so its
+            // cost is paid page by page as buckets split, not all at once
+            auto* fresh = static_cast<atomic<SetNode*>*>(calloc(size, sizeof(atomic<SetNode*>)));
+            if(fresh == nullptr)
+            {
+                throw bad_alloc();
+            }
+            if(segments[s].compare_exchange_strong(segment, fresh, memory_order_acq_rel))
+            {
+                segment = fresh;
+            }
+            else
+            {
+                free(fresh);
+            }
+        }
+        return segment[bucket - base];
+    }
+
+    void retire(SetNode* node)
+    {
+        SetNode* top = retired.load(memory_order_relaxed);
+        do
+        {
+            node->retiredNext = top;
+        } while(!retired.compare_exchange_weak(top, node, memory_order_release, memory_order_relaxed));
+    }
+
+    // does node sort before (splitKey, key)?
+    static bool before(const SetNode* node, uint64_t splitKey, const Key& key)
+    {
+        if(node->splitKey != splitKey)
+        {
+            return node->splitKey < splitKey;
+        }
+        return (splitKey & 1) && node->key < key;
+    }
+
+    // Michael's search: on return *prev points at curr (unmarked), curr is
+    // the first node not before (splitKey, key) or nullptr, and every marked
+    // node met on the way has been unlinked
+    void search(SetNode* start, uint64_t splitKey, const Key& key, atomic<uintptr_t>*& prev, SetNode*& curr)
+    {
+    retry:
+        prev = &start->next;
+        curr = ptr(prev->load(memory_order_acquire));
+        while(curr != nullptr)
+        {
+            uintptr_t next = curr->next.load(memory_order_acquire);
+            if(marked(next))
+            {
+                uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+                if(!prev->compare_exchange_strong(expected, next & ~MARK, memory_order_acq_rel))
+                {
+                    goto retry;
+                }
+                retire(curr);
+                curr = ptr(next);
+                continue;
+            }
+            if(!before(curr, splitKey, key))
+            {
+                return;
+            }
+            prev = &curr->next;
+            curr = ptr(next);
+        }
+    }
+
+    // the dummy of bucket b, inserting it (and its parents') on first use
+    SetNode* bucketHead(size_t b)
+    {
+        atomic<SetNode*>& s = slot(b);
+        SetNode* dummy = s.load(memory_order_acquire);
+        if(dummy != nullptr)
+        {
+            return dummy;
+        }
+        size_t parent = b & ~((size_t)1 << (63 - __builtin_clzll(b)));
+        SetNode* start = bucketHead(parent);
+        SetNode* fresh = new SetNode(dummyKey(b), Key());
+        for (;;)
+        {
+            atomic<uintptr_t>* prev;
+            SetNode* curr;
+            search(start, fresh->splitKey, fresh->key, prev, curr);
+            if(curr != nullptr && curr->splitKey == fresh->splitKey)
+            {
+                // another thread got there first; dummies are never removed
+                delete fresh;
+                fresh = curr;
+                break;
+            }
+            fresh->next.store(reinterpret_cast<uintptr_t>(curr), memory_order_relaxed);
+            uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+            if(prev->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(fresh), memory_order_acq_rel))
+            {
+                break;
+            }
+        }
+        s.store(fresh, memory_order_release);
+        return fresh;
+    }
+
+    SetNode* startFor(uint64_t h) { return bucketHead(h & (bucketCount.load(memory_order_acquire) - 1)); }
+
+public:
+    SplitOrderedSet(size_t initialBuckets = 16, double maxLoad = 2.0) : maxLoad(maxLoad)
+    {
+        size_t buckets = 2;
+        while(buckets < initialBuckets)
+        {
+            buckets <<= 1;
+        }
+        for (auto& s : segments)
+        {
+            s.store(nullptr, memory_order_relaxed);
+        }
+        bucketCount.store(buckets);
+        elements.store(0);
+        retired.store(nullptr);
+        head = new SetNode(dummyKey(0), Key());
+        slot(0).store(head);
+    }
+
+    SplitOrderedSet(const SplitOrderedSet&) = delete;
+    SplitOrderedSet& operator=(const SplitOrderedSet&) = delete;
+
+    ~SplitOrderedSet()
+    {
+        reclaim();
+        for (SetNode* p = head; p != nullptr;)
+        {
+            SetNode* next = ptr(p->next.load());
+            delete p;
+            p = next;
+        }
+        for (auto& s : segments)
+        {
+            free(s.load());
+        }
+    }
+
+    bool insert(const Key& key)
+    {
+        uint64_t h = hashOf(key);
+        SetNode* start = startFor(h);
+        SetNode* node = new SetNode(regularKey(h), key);
+        for (;;)
+        {
+            atomic<uintptr_t>* prev;
+            SetNode* curr;
+            search(start, node->splitKey, key, prev, curr);
+            if(curr != nullptr && curr->splitKey == node->splitKey && curr->key == key)
+            {
+                delete node;
+                return false;
+            }
+            node->next.store(reinterpret_cast<uintptr_t>(curr), memory_order_relaxed);
+            uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+            if(prev->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), memory_order_acq_rel))
+            {
+                break;
+            }
+        }
+        size_t n = elements.fetch_add(1, memory_order_relaxed) + 1;
+        size_t buckets = bucketCount.load(memory_order_relaxed);
+        if(n > maxLoad * buckets && buckets < ((size_t)1 << (SEGMENTS - 1)))
+        {
+            // only the count doubles here; new buckets split off on first use
+            bucketCount.compare_exchange_strong(buckets, buckets * 2, memory_order_acq_rel);
+        }
+        return true;
+    }
+
+    bool remove(const Key& key)
+    {
+        uint64_t h = hashOf(key);
+        uint64_t splitKey = regularKey(h);
+        SetNode* start = startFor(h);
+        for (;;)
+        {
+            atomic<uintptr_t>* prev;
+            SetNode* curr;
+            search(start, splitKey, key, prev, curr);
+            if(curr == nullptr || curr->splitKey != splitKey || !(curr->key == key))
+            {
+                return false;
+            }
+            uintptr_t next = curr->next.load(memory_order_acquire);
+            if(marked(next))
+            {
+                continue;
+            }
+            // the mark is the linearization point; unlinking is cleanup
+            if(!curr->next.compare_exchange_strong(next, next | MARK, memory_order_acq_rel))
+            {
+                continue;
+            }
+            elements.fetch_sub(1, memory_order_relaxed);
+            uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+            if(prev->compare_exchange_strong(expected, next, memory_order_acq_rel))
+            {
+                retire(curr);
+            }
+            else
+            {
+                search(start, splitKey, key, prev, curr);
+            }
+            return true;
+        }
+    }
+
+    // read-only: never writes, never retries
+    bool contains(const Key& key)
+    {
+        uint64_t h = hashOf(key);
+        uint64_t splitKey = regularKey(h);
+        SetNode* curr = startFor(h);
+        while(curr != nullptr && before(curr, splitKey, key))
+        {
+            curr = ptr(curr->next.load(memory_order_acquire));
+        }
+        return curr != nullptr && curr->splitKey == splitKey && curr->key == key &&
+               !marked(curr->next.load(memory_order_acquire));
+    }
+
+    size_t size() const { return elements.load(memory_order_relaxed); }
+    size_t buckets() const { return bucketCount.load(memory_order_relaxed); }
+
+    // frees removed nodes; only while no other thread is using the set
+    size_t reclaim()
+    {
+        size_t freed = 0;
+        for (SetNode* p = retired.exchange(nullptr); p != nullptr; freed++)
+        {
+            SetNode* next = p->retiredNext;
+            delete p;
+            p = next;
+        }
+        return freed;
+    }
+
+    // visits every element; only while no other thread is modifying the set
+    template <class F>
+    void forEach(F f) const
+    {
+        for (SetNode* p = ptr(head->next.load()); p != nullptr; p = ptr(p->next.load()))
+        {
+            if((p->splitKey & 1) && !marked(p->next.load()))
+            {
+                f(p->key);
+            }
+        }
+    }
+};
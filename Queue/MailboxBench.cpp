@@ -0,0 +1,193 @@
+#include <bits/stdc++.h>
+#include "MpscQueue.cpp"
+using namespace std;
+
+// Actor-mailbox workload: P producers, one consumer, 2^21 messages in total.
+// Three queues, all moving pointers to preallocated messages:
+//   MpscQueue     intrusive, push = one exchange (MpscQueue.cpp)
+//   MPMC ring     Vyukov's bounded MPMC array queue, the general design
+//                 (a CAS on the enqueue position per push, per-cell sequence
+//                 numbers); producers yield when it is full
+//   mutex queue   std::mutex around an intrusive list using the same hook
+// Every 64th push is timed on its own for the enqueue latency percentiles;
+// the consumer checks that each producer's messages arrive in order.
+
+struct Message : MpscHook {
+    int producer;
+    int seq;
+};
+
+class MpmcRing {
+   private:
+    struct Cell {
+        atomic<size_t> seq;
+        Message* value;
+    };
+    vector<Cell> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> enqueuePos{0};
+    alignas(64) atomic<size_t> dequeuePos{0};
+
+   public:
+    MpmcRing(size_t capacity) : cells(capacity), mask(capacity - 1) {
+        for (size_t i = 0; i < capacity; i++) cells[i].seq.store(i, memory_order_relaxed);
+    }
+
+    bool tryPush(Message* m) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells[pos & mask];
+            intptr_t diff = (intptr_t)c.seq.load(memory_order_acquire) - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    c.value = m;
+                    c.seq.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(Message* m) {
+        while (!tryPush(m)) this_thread::yield();
+    }
+
+    Message* pop() {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells[pos & mask];
+            intptr_t diff = (intptr_t)c.seq.load(memory_order_acquire) - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    Message* m = c.value;
+                    c.seq.store(pos + mask + 1, memory_order_release);
+                    return m;
+                }
+            } else if (diff < 0) {
+                return nullptr;  // empty
+            } else {
+                pos = dequeuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+};
+
+class MutexQueue {
+   private:
+    mutex m;
+    MpscHook* head = nullptr;
+    MpscHook* tail = nullptr;
+
+   public:
+    void push(Message* x) {
+        x->next.store(nullptr, memory_order_relaxed);
+        lock_guard<mutex> lock(m);
+        if (tail) {
+            tail->next.store(x, memory_order_relaxed);  // only touched under the lock
+        } else {
+            head = x;
+        }
+        tail = x;
+    }
+
+    Message* pop() {
+        lock_guard<mutex> lock(m);
+        if (!head) return nullptr;
+        MpscHook* h = head;
+        head = h->next.load(memory_order_relaxed);
+        if (!head) tail = nullptr;
+        return static_cast<Message*>(h);
+    }
+};
+
+// median cost of the two clock reads around a timed push
+long long clockOverhead() {
+    vector<long long> empty(1001);
+    for (auto& e : empty) {
+        auto a = chrono::steady_clock::now();
+        auto b = chrono::steady_clock::now();
+        e = chrono::duration_cast<chrono::nanoseconds>(b - a).count();
+    }
+    nth_element(empty.begin(), empty.begin() + 500, empty.end());
+    return empty[500];
+}
+
+template <class Queue>
+void run(const string& name, Queue& q, int producers) {
+    const int TOTAL = 1 << 21, SAMPLE = 64;
+    int perProducer = TOTAL / producers;
+    vector<unique_ptr<Message[]>> messages(producers);
+    for (auto& m : messages) m.reset(new Message[perProducer]);
+    vector<vector<long long>> samples(producers);
+    atomic<bool> go(false);
+    long long overhead = clockOverhead();
+
+    vector<thread> pool;
+    for (int p = 0; p < producers; p++) {
+        pool.emplace_back([&, p]() {
+            Message* mine = messages[p].get();
+            samples[p].reserve(perProducer / SAMPLE + 1);
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            for (int i = 0; i < perProducer; i++) {
+                mine[i].producer = p;
+                mine[i].seq = i;
+                if (i % SAMPLE) {
+                    q.push(&mine[i]);
+                    continue;
+                }
+                auto a = chrono::steady_clock::now();
+                q.push(&mine[i]);
+                auto b = chrono::steady_clock::now();
+                samples[p].push_back(max(0LL, (long long)chrono::duration_cast<chrono::nanoseconds>(b - a).count() - overhead));
+            }
+        });
+    }
+
+    vector<int> expect(producers, 0);
+    long long received = 0, outOfOrder = 0;
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    while (received < (long long)perProducer * producers) {
+        Message* m = q.pop();
+        if (!m) {
+            this_thread::yield();
+            continue;
+        }
+        outOfOrder += m->seq != expect[m->producer];
+        expect[m->producer] = m->seq + 1;
+        received++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (auto& t : pool) t.join();
+
+    vector<long long> all;
+    for (auto& s : samples) all.insert(all.end(), s.begin(), s.end());
+    sort(all.begin(), all.end());
+    cout << "  " << left << setw(12) << name << right << setw(4) << producers << " producers: " << setw(6)
+         << (long long)(received / seconds / 1e6) << " M msgs/s, enqueue p50 " << setw(5) << all[all.size() / 2]
+         << " ns, p99 " << setw(7) << all[all.size() * 99 / 100] << " ns"
+         << (outOfOrder ? ", " + to_string(outOfOrder) + " OUT OF ORDER" : "") << endl;
+}
+
+int main() {
+    cout << "2^21 messages, one consumer (enqueue latency has the clock overhead subtracted):" << endl;
+    for (int producers : {1, 2, 4, 8, 16, 32, 64}) {
+        {
+            MpscQueue<Message> q;
+            run("MpscQueue", q, producers);
+        }
+        {
+            MpmcRing q(1 << 16);
+            run("MPMC ring", q, producers);
+        }
+        {
+            MutexQueue q;
+            run("mutex queue", q, producers);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Vyukov's intrusive multi-producer single-consumer queue.
+//
+// Messages carry their own link, like the `next` of LinkedList/'s Node, by
+// inheriting MpscHook, so enqueueing allocates nothing. The queue is a singly
+// linked list from `tail` (oldest, consumer side) to `head` (newest):
+//   push  one atomic exchange on head, then a plain store linking the old
+//         head to the new node: wait-free, no CAS, no retry loop
+//   pop   single consumer only, no CAS: follows tail->next
+// A permanent stub node keeps the list non-empty, so neither side ever has
+// to special-case an empty queue.
+//
+// The one subtlety: between a producer's exchange and its link store, the
+// new node is not yet reachable. If the consumer reaches that gap, pop()
+// returns nullptr although the queue is not empty; the message shows up as
+// soon as that producer's next instruction runs. Nothing is lost, but a
+// producer preempted exactly there delays the messages behind it. Consumer
+// loops that treat nullptr as "try again later" are unaffected.
+
+struct MpscHook {
+    atomic<MpscHook*> next{nullptr};
+};
+
+template <class T>
+class MpscQueue {
+   private:
+    alignas(64) atomic<MpscHook*> head;  // producers
+    alignas(64) MpscHook* tail;          // consumer
+    MpscHook stub;
+
+    void pushHook(MpscHook* h) {
+        h->next.store(nullptr, memory_order_relaxed);
+        MpscHook* prev = head.exchange(h, memory_order_acq_rel);
+        prev->next.store(h, memory_order_release);
+    }
+
+   public:
+    MpscQueue() : head(&stub), tail(&stub) {}
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // any thread
+    void push(T* x) { pushHook(static_cast<MpscHook*>(x)); }
+
+    // consumer thread only; nullptr when empty (or a push is half done, see above)
+    T* pop() {
+        MpscHook* t = tail;
+        MpscHook* next = t->next.load(memory_order_acquire);
+        if (t == &stub) {
+            if (next == nullptr) return nullptr;
+            tail = t = next;
+            next = t->next.load(memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return static_cast<T*>(t);
+        }
+        // t is the last linked node; taking it would leave tail dangling, so
+        // re-insert the stub behind it first, unless a push is in flight
+        if (t != head.load(memory_order_acquire)) return nullptr;
+        pushHook(&stub);
+        next = t->next.load(memory_order_acquire);
+        if (next != nullptr) {
+            tail = next;
+            return static_cast<T*>(t);
+        }
+        return nullptr;
+    }
+
+    // consumer thread only
+    bool empty() const { return tail == &stub && stub.next.load(memory_order_acquire) == nullptr; }
+};
@@ -0,0 +1,127 @@
+#include <bits/stdc++.h>
+#include "SpscQueue.cpp"
+using namespace std;
+
+// One producer stage, one consumer stage, 256 MB of payload per run, at
+// three payload sizes. SpscQueue (SpscQueue.cpp) against a mutex-guarded
+// deque, with a single-threaded memcpy of the same bytes as the bandwidth
+// ceiling. SpscQueue runs twice on the same instance; a run allocates nodes
+// only where its backlog grows past the deepest one so far, otherwise every
+// node comes from the recycled cache. The consumer checks order and a
+// checksum of every payload.
+
+template <size_t BYTES>
+struct Payload {
+    uint64_t seq;
+    char bytes[BYTES - sizeof(uint64_t)];
+};
+
+template <>
+struct Payload<8> {
+    uint64_t seq;
+};
+
+template <class T>
+class MutexDeque {
+   private:
+    mutex m;
+    deque<T> items;
+
+   public:
+    void push(T value) {
+        lock_guard<mutex> lock(m);
+        items.push_back(move(value));
+    }
+
+    bool pop(T& out) {
+        lock_guard<mutex> lock(m);
+        if (items.empty()) return false;
+        out = move(items.front());
+        items.pop_front();
+        return true;
+    }
+};
+
+template <class P>
+P makePayload(uint64_t seq) {
+    P p;
+    p.seq = seq;
+    if constexpr (sizeof(P) > sizeof(uint64_t)) memset(p.bytes, (int)(seq & 0x7F), sizeof(p.bytes));
+    return p;
+}
+
+// last payload byte, so the checksum reads the whole payload's far end
+template <class P>
+uint64_t fill(const P& p) {
+    if constexpr (sizeof(P) > sizeof(uint64_t)) {
+        return (unsigned char)p.bytes[sizeof(p.bytes) - 1];
+    } else {
+        return p.seq & 0x7F;
+    }
+}
+
+// returns seconds; ok is false on a lost, reordered or corrupted payload
+template <class P, class Queue>
+double transfer(Queue& q, uint64_t count, bool& ok) {
+    uint64_t expectSum = 0, sum = 0, next = 0;
+    for (uint64_t i = 0; i < count; i++) expectSum += i + (i & 0x7F);
+    auto start = chrono::steady_clock::now();
+    thread producer([&]() {
+        for (uint64_t i = 0; i < count; i++) q.push(makePayload<P>(i));
+    });
+    P p;
+    while (next < count) {
+        if (!q.pop(p)) {
+            this_thread::yield();
+            continue;
+        }
+        ok = ok && p.seq == next;
+        sum += p.seq + fill(p);
+        next++;
+    }
+    producer.join();
+    ok = ok && sum == expectSum;
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <size_t BYTES>
+void payloadSize() {
+    typedef Payload<BYTES> P;
+    const uint64_t TOTAL_BYTES = 256ULL << 20, count = TOTAL_BYTES / BYTES;
+    auto line = [&](const string& name, double seconds, const string& extra) {
+        cout << "  " << left << setw(22) << name << right << fixed << setprecision(1) << setw(8)
+             << count / seconds / 1e6 << " M items/s " << setw(6) << setprecision(2) << TOTAL_BYTES / seconds / 1e9
+             << " GB/s" << extra << endl;
+        cout.unsetf(ios::floatfield);
+    };
+    cout << BYTES << "-byte payloads, " << count << " per run:" << endl;
+
+    {
+        vector<P> src(min<uint64_t>(count, (64 << 20) / BYTES)), dst(src.size());
+        for (size_t i = 0; i < src.size(); i++) src[i] = makePayload<P>(i);
+        auto start = chrono::steady_clock::now();
+        for (uint64_t done = 0; done < count; done += src.size()) memcpy(dst.data(), src.data(), src.size() * BYTES);
+        line("memcpy (ceiling)", chrono::duration<double>(chrono::steady_clock::now() - start).count(), "");
+    }
+
+    SpscQueue<P> spsc;
+    for (int run = 1; run <= 2; run++) {
+        bool ok = true;
+        size_t before = spsc.nodesAllocated();
+        double seconds = transfer<P>(spsc, count, ok);
+        line("SpscQueue, run " + to_string(run), seconds,
+             ", " + to_string(spsc.nodesAllocated() - before) + " new nodes" + (ok ? "" : ", WRONG DATA"));
+    }
+
+    MutexDeque<P> locked;
+    bool ok = true;
+    double seconds = transfer<P>(locked, count, ok);
+    line("mutex + deque", seconds, ok ? "" : ", WRONG DATA");
+}
+
+int main() {
+    payloadSize<8>();
+    payloadSize<64>();
+    payloadSize<256>();
+    return 0;
+}
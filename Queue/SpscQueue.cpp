@@ -0,0 +1,97 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Unbounded single-producer single-consumer queue of linked nodes, with the
+// consumed nodes recycled back to the producer (Vyukov's node-caching SPSC).
+//
+// All nodes, live or spent, form one chain:
+//
+//   first ... tailCopy ... tail -> (values) -> ... -> head
+//   \__ producer's cache __/  ^ consumer's dummy     ^ last pushed
+//
+// The consumer pops by moving `tail` one node forward; the node it leaves
+// behind is spent. The producer owns everything before `tail` and takes spent
+// nodes from `first` instead of allocating. It reads the shared `tail` only
+// when its cached copy runs out, so in steady state the two threads share
+// nothing but the node links being handed over and one tail load per
+// exhausted cache batch. Both sides are wait-free; push allocates only while
+// the queue is longer than it has ever been.
+//
+// Producer and consumer state sit on separate cache lines (alignas also pads
+// the object to a whole number of lines). Nodes are freed only by the
+// destructor; the chain never shrinks.
+
+template <class T>
+class SpscQueue {
+   private:
+    struct QNode {
+        atomic<QNode*> next{nullptr};
+        T value;
+    };
+
+    // consumer side
+    alignas(64) atomic<QNode*> tail;
+
+    // producer side
+    alignas(64) QNode* head;
+    QNode* first;     // oldest spent node
+    QNode* tailCopy;  // spent nodes are [first, tailCopy)
+    size_t allocations = 0;
+
+    QNode* takeNode() {
+        if (first != tailCopy) {
+            QNode* n = first;
+            first = first->next.load(memory_order_relaxed);
+            return n;
+        }
+        tailCopy = tail.load(memory_order_acquire);
+        if (first != tailCopy) {
+            QNode* n = first;
+            first = first->next.load(memory_order_relaxed);
+            return n;
+        }
+        allocations++;
+        return new QNode();
+    }
+
+   public:
+    SpscQueue() {
+        QNode* dummy = new QNode();
+        tail.store(dummy, memory_order_relaxed);
+        head = first = tailCopy = dummy;
+        allocations = 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue() {
+        for (QNode* n = first; n != nullptr;) {
+            QNode* next = n->next.load(memory_order_relaxed);
+            delete n;
+            n = next;
+        }
+    }
+
+    // producer thread only
+    void push(T value) {
+        QNode* n = takeNode();
+        n->next.store(nullptr, memory_order_relaxed);
+        n->value = move(value);
+        head->next.store(n, memory_order_release);
+        head = n;
+    }
+
+    // consumer thread only; false when empty
+    bool pop(T& out) {
+        QNode* t = tail.load(memory_order_relaxed);
+        QNode* n = t->next.load(memory_order_acquire);
+        if (n == nullptr) return false;
+        out = move(n->value);
+        tail.store(n, memory_order_release);  // t is now spent
+        return true;
+    }
+
+    // producer thread only: nodes ever allocated, the dummy included
+    size_t nodesAllocated() const { return allocations; }
+};
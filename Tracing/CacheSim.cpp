@@ -0,0 +1,240 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Address traces and an offline cache/TLB simulator, for comparing data
+// layouts where hardware counters (perf) are not available.
+//
+// A kernel is written against a probe: it calls probe.read(p, bytes) or
+// probe.write(p, bytes) for every load or store it wants counted, and
+// probe.endOp() after each logical operation (one find, one list hop).
+// AddressTrace is the probe that records; it can be saved and loaded in a
+// fixed little-endian format, so a trace captured on one machine can be
+// replayed on another.
+//
+// Replay runs every access through a TLB hierarchy and a cache hierarchy,
+// each a chain of set-associative LRU levels. All levels are filled on a
+// miss and nothing is invalidated (non-inclusive, no write-back modelling),
+// the usual first-order model. Results are deterministic for a given trace,
+// so two layouts can be compared exactly, run to run.
+//
+// Addresses are real virtual addresses. ASLR moves them by whole pages, so
+// set indices below the page size, and therefore L1 behaviour, do not change
+// between runs.
+
+struct MemAccess {
+    uint64_t addr;
+    uint32_t bytes;
+    bool write;
+};
+
+class AddressTrace {
+   public:
+    vector<MemAccess> accesses;
+    vector<size_t> opEnd;  // accesses[opEnd[i - 1] .. opEnd[i]) belong to op i
+
+    void read(const void* p, uint32_t bytes) { accesses.push_back({(uint64_t)(uintptr_t)p, bytes, false}); }
+    void write(const void* p, uint32_t bytes) { accesses.push_back({(uint64_t)(uintptr_t)p, bytes, true}); }
+    void endOp() { opEnd.push_back(accesses.size()); }
+
+    size_t opCount() const { return opEnd.size(); }
+
+    void clear() {
+        accesses.clear();
+        opEnd.clear();
+    }
+
+    // "ADRT", u64 op count, u64 op ends, u64 access count, then per access
+    // u64 addr, u32 bytes, u8 write. Every field is written byte by byte,
+    // little-endian, so the file does not depend on the host's struct layout,
+    // word size or byte order.
+    void save(const string& path) const {
+        vector<uint8_t> buf;
+        buf.reserve(4 + 8 * (2 + opEnd.size()) + 13 * accesses.size());
+        auto put = [&](uint64_t v, int bytes) {
+            for (int i = 0; i < bytes; i++) buf.push_back((uint8_t)(v >> (8 * i)));
+        };
+        buf.insert(buf.end(), {'A', 'D', 'R', 'T'});
+        put(opEnd.size(), 8);
+        for (size_t e : opEnd) put(e, 8);
+        put(accesses.size(), 8);
+        for (const MemAccess& a : accesses) {
+            put(a.addr, 8);
+            put(a.bytes, 4);
+            put(a.write, 1);
+        }
+        ofstream out(path, ios::binary);
+        if (!out) throw runtime_error("cannot create " + path);
+        out.write((const char*)buf.data(), buf.size());
+        if (!out) throw runtime_error("trace write failed");
+    }
+
+    static AddressTrace load(const string& path) {
+        ifstream in(path, ios::binary);
+        if (!in) throw runtime_error("cannot open " + path);
+        vector<uint8_t> buf((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        size_t pos = 0;
+        auto get = [&](int bytes) {
+            if (buf.size() - pos < (size_t)bytes) throw runtime_error(path + ": truncated");
+            uint64_t v = 0;
+            for (int i = 0; i < bytes; i++) v |= (uint64_t)buf[pos++] << (8 * i);
+            return v;
+        };
+        if (buf.size() < 4 || memcmp(buf.data(), "ADRT", 4) != 0) throw runtime_error(path + ": not an address trace");
+        pos = 4;
+        AddressTrace t;
+        uint64_t ops = get(8);
+        if (ops > (buf.size() - pos) / 8) throw runtime_error(path + ": truncated");
+        t.opEnd.resize(ops);
+        for (auto& e : t.opEnd) e = get(8);
+        uint64_t count = get(8);
+        if (count > (buf.size() - pos) / 13) throw runtime_error(path + ": truncated");
+        t.accesses.resize(count);
+        for (MemAccess& a : t.accesses) {
+            a.addr = get(8);
+            a.bytes = get(4);
+            a.write = get(1) != 0;
+        }
+        return t;
+    }
+};
+
+// The probe to pass when a kernel runs for real: every call compiles away.
+struct NullProbe {
+    void read(const void*, uint32_t) {}
+    void write(const void*, uint32_t) {}
+    void endOp() {}
+};
+
+struct LevelConfig {
+    string name;
+    uint64_t capacity;  // bytes, or entries * page size for a TLB
+    uint32_t blockBytes;  // line size, or page size for a TLB
+    uint32_t ways;
+    uint32_t missCycles;  // added to the estimate for each miss at this level
+};
+
+// one set-associative level with true LRU; each set keeps its tags in MRU order
+class SetAssociative {
+   private:
+    LevelConfig config;
+    int blockShift;
+    uint64_t sets;
+    vector<uint64_t> tags;  // sets * ways, ~0 = empty
+    vector<uint32_t> filled;
+
+   public:
+    SetAssociative(const LevelConfig& c) : config(c) {
+        if (c.blockBytes == 0 || (c.blockBytes & (c.blockBytes - 1))) throw invalid_argument(c.name + ": block size must be a power of two");
+        if (c.ways == 0 || c.capacity % ((uint64_t)c.blockBytes * c.ways)) throw invalid_argument(c.name + ": capacity must be a multiple of block * ways");
+        blockShift = __builtin_ctz(c.blockBytes);
+        sets = c.capacity / c.blockBytes / c.ways;
+        tags.assign(sets * c.ways, ~0ULL);
+        filled.assign(sets, 0);
+    }
+
+    const LevelConfig& cfg() const { return config; }
+    uint64_t block(uint64_t addr) const { return addr >> blockShift; }
+
+    // true on a hit; on a miss the block is inserted, evicting the LRU entry
+    bool access(uint64_t blockId) {
+        uint64_t* set = &tags[(blockId % sets) * config.ways];
+        uint32_t& n = filled[blockId % sets];
+        for (uint32_t w = 0; w < n; w++) {
+            if (set[w] == blockId) {
+                memmove(set + 1, set, w * sizeof(uint64_t));
+                set[0] = blockId;
+                return true;
+            }
+        }
+        if (n < config.ways) n++;
+        memmove(set + 1, set, (n - 1) * sizeof(uint64_t));
+        set[0] = blockId;
+        return false;
+    }
+};
+
+struct HierarchyConfig {
+    vector<LevelConfig> caches, tlbs;
+    uint32_t hitCycles = 4;  // per line touched; misses add each missed level's missCycles
+
+    // a recent desktop core: 48K/12 L1, 2M/16 L2, a 32M/16 slice of L3,
+    // 64-entry L1 dTLB and a 2048-entry STLB, 4K pages
+    static HierarchyConfig desktop() {
+        HierarchyConfig h;
+        h.caches = {{"L1d", 48 << 10, 64, 12, 12}, {"L2", 2 << 20, 64, 16, 30}, {"L3", 32 << 20, 64, 16, 200}};
+        h.tlbs = {{"dTLB", 64 * 4096, 4096, 4, 7}, {"STLB", 2048 * 4096, 4096, 16, 30}};
+        return h;
+    }
+};
+
+struct SimResult {
+    vector<string> names;         // cache levels, then TLB levels
+    vector<uint64_t> misses;      // parallel to names
+    uint64_t ops = 0, accesses = 0, lines = 0;
+    uint64_t cycles = 0;          // hit cost + miss penalties, no overlap between misses
+
+    double perOp(uint64_t x) const { return ops ? (double)x / ops : 0.0; }
+};
+
+class CacheSimulator {
+   private:
+    HierarchyConfig config;
+    vector<SetAssociative> caches, tlbs;
+    SimResult result;
+
+    void touchLine(uint64_t addr) {
+        result.lines++;
+        result.cycles += config.hitCycles;
+        for (size_t i = 0; i < caches.size(); i++) {
+            if (caches[i].access(caches[i].block(addr))) break;
+            result.misses[i]++;
+            result.cycles += caches[i].cfg().missCycles;
+        }
+        for (size_t i = 0; i < tlbs.size(); i++) {
+            if (tlbs[i].access(tlbs[i].block(addr))) break;
+            result.misses[caches.size() + i]++;
+            result.cycles += tlbs[i].cfg().missCycles;
+        }
+    }
+
+   public:
+    CacheSimulator(const HierarchyConfig& c) : config(c) {
+        for (auto& l : c.caches) caches.emplace_back(l), result.names.push_back(l.name);
+        for (auto& l : c.tlbs) tlbs.emplace_back(l), result.names.push_back(l.name);
+        if (caches.empty()) throw invalid_argument("at least one cache level is needed");
+        result.misses.assign(result.names.size(), 0);
+    }
+
+    // an access counts once per cache line it overlaps
+    void access(const MemAccess& a) {
+        result.accesses++;
+        uint64_t lineBytes = caches[0].cfg().blockBytes;
+        uint64_t first = a.addr / lineBytes, last = (a.addr + max(a.bytes, 1u) - 1) / lineBytes;
+        for (uint64_t line = first; line <= last; line++) touchLine(line * lineBytes);
+    }
+
+    // replays ops [0, warmupOps) without counting them, then the rest
+    SimResult run(const AddressTrace& trace, size_t warmupOps = 0) {
+        size_t begin = 0;
+        for (size_t op = 0; op < trace.opCount(); op++) {
+            if (op == warmupOps) resetCounters();
+            for (size_t i = begin; i < trace.opEnd[op]; i++) access(trace.accesses[i]);
+            begin = trace.opEnd[op];
+            if (op >= warmupOps) result.ops++;
+        }
+        return result;
+    }
+
+    void resetCounters() {
+        vector<string> names = result.names;
+        result = SimResult();
+        result.names = names;
+        result.misses.assign(names.size(), 0);
+    }
+};
+
+SimResult simulate(const AddressTrace& trace, const HierarchyConfig& config = HierarchyConfig::desktop(),
+                   size_t warmupOps = 0) {
+    CacheSimulator sim(config);
+    return sim.run(trace, warmupOps);
+}
@@ -0,0 +1,265 @@
+#include <bits/stdc++.h>
+#include "CacheSim.cpp"
+using namespace std;
+
+// Predicted cache and TLB misses per operation for two kernels, each over
+// several layouts of the same data, from address traces (see CacheSim.cpp):
+//   - UnionFind find with full path compression, on a forest built by random
+//     unions by rank: parent/rank as separate arrays (the layout of
+//     UnionFind.cpp), as interleaved pairs, and renumbered so that every
+//     tree's members are contiguous.
+//   - the next-pointer hops of Reverse (LinkedList/Reverse.cpp): nodes from
+//     new in list order, nodes from new linked in shuffled order (an aged
+//     heap), one arena in list order, 64-node blocks in shuffled order, and
+//     a bare index array.
+// The same kernel also runs untraced (NullProbe) for a measured ns/op next to
+// the prediction.
+
+struct SplitParent {
+    vector<int> parent, rank;
+    int& p(int x) { return parent[x]; }
+    int& r(int x) { return rank[x]; }
+};
+
+struct PairedParent {
+    vector<pair<int, int>> entry;  // {parent, rank}
+    int& p(int x) { return entry[x].first; }
+    int& r(int x) { return entry[x].second; }
+};
+
+// find as in UnionFind.cpp, iterative: locate the root, then point the path at it
+template <class Layout, class Probe>
+int find(Layout& l, int x, Probe& probe) {
+    int root = x;
+    for (;;) {
+        probe.read(&l.p(root), 4);
+        if (l.p(root) == root) break;
+        root = l.p(root);
+    }
+    while (x != root) {
+        probe.read(&l.p(x), 4);
+        int next = l.p(x);
+        probe.write(&l.p(x), 4);
+        l.p(x) = root;
+        x = next;
+    }
+    return root;
+}
+
+template <class Layout>
+void unionByRank(Layout& l, int u, int v) {
+    NullProbe none;
+    u = find(l, u, none);
+    v = find(l, v, none);
+    if (u == v) return;
+    if (l.r(u) < l.r(v)) swap(u, v);
+    l.p(v) = u;
+    if (l.r(u) == l.r(v)) l.r(u)++;
+}
+
+struct Row {
+    string layout;
+    SimResult sim;
+    double measuredNs;
+};
+
+void printRows(const vector<Row>& rows) {
+    cout << "  " << left << setw(26) << "layout" << right << setw(9) << "lines/op";
+    for (auto& name : rows[0].sim.names) cout << setw(8) << name;
+    cout << setw(12) << "est cyc/op" << setw(12) << "measured ns" << endl;
+    for (auto& row : rows) {
+        cout << "  " << left << setw(26) << row.layout << right << fixed << setprecision(2) << setw(9)
+             << row.sim.perOp(row.sim.lines);
+        for (uint64_t m : row.sim.misses) cout << setw(8) << row.sim.perOp(m);
+        cout << setw(12) << setprecision(1) << row.sim.perOp(row.sim.cycles) << setw(12) << row.measuredNs << endl;
+    }
+    cout.unsetf(ios::floatfield);
+}
+
+template <class Layout>
+Row findRow(const string& name, const Layout& built, const vector<int>& queries) {
+    const size_t warmup = queries.size() / 4;
+    AddressTrace trace;
+    Layout traced = built;
+    for (int q : queries) {
+        find(traced, q, trace);
+        trace.endOp();
+    }
+
+    Layout timed = built;
+    NullProbe none;
+    long long sink = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (int q : queries) sink += find(timed, q, none);
+    double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - start).count() / queries.size();
+    if (sink == -1) cout << endl;
+    return {name, simulate(trace, HierarchyConfig::desktop(), warmup), ns};
+}
+
+void unionFindLayouts() {
+    const int n = 1 << 22;
+    mt19937 rng(7);
+    SplitParent split{vector<int>(n), vector<int>(n, 0)};
+    iota(split.parent.begin(), split.parent.end(), 0);
+    for (int i = 0; i < n / 2; i++) unionByRank(split, rng() % n, rng() % n);
+
+    PairedParent paired{vector<pair<int, int>>(n)};
+    for (int i = 0; i < n; i++) paired.entry[i] = {split.parent[i], split.rank[i]};
+
+    // renumbered: members of one tree get consecutive ids, parents before children
+    vector<vector<int>> children(n);
+    for (int i = 0; i < n; i++) {
+        if (split.parent[i] != i) children[split.parent[i]].push_back(i);
+    }
+    vector<int> newId(n, -1), order;
+    order.reserve(n);
+    for (int root = 0; root < n; root++) {
+        if (split.parent[root] != root) continue;
+        size_t k = order.size();
+        order.push_back(root);
+        for (; k < order.size(); k++) {
+            for (int c : children[order[k]]) order.push_back(c);
+        }
+    }
+    for (int i = 0; i < n; i++) newId[order[i]] = i;
+    SplitParent renumbered{vector<int>(n), vector<int>(n)};
+    for (int i = 0; i < n; i++) {
+        renumbered.parent[newId[i]] = newId[split.parent[i]];
+        renumbered.rank[newId[i]] = split.rank[i];
+    }
+
+    vector<int> queries(1 << 20), renamed(queries.size());
+    for (auto& q : queries) q = rng() % n;
+    for (size_t i = 0; i < queries.size(); i++) renamed[i] = newId[queries[i]];
+
+    cout << "find on 2^22 elements after 2^21 random unions by rank, 2^20 random finds (first quarter warms up):"
+         << endl;
+    printRows({findRow("parent[] + rank[]", split, queries), findRow("{parent, rank} pairs", paired, queries),
+               findRow("renumbered by tree", renumbered, renamed)});
+}
+
+struct Node {
+    int data;
+    Node* next;
+    Node(int v) : data(v), next(nullptr) {}
+};
+
+template <class Probe>
+Node* reverse(Node* head, Probe& probe) {
+    Node *prev = nullptr, *curr = head;
+    while (curr) {
+        probe.read(&curr->next, sizeof(Node*));
+        Node* next = curr->next;
+        probe.write(&curr->next, sizeof(Node*));
+        curr->next = prev;
+        prev = curr;
+        curr = next;
+        probe.endOp();
+    }
+    return prev;
+}
+
+template <class Probe>
+int reverseIndexed(vector<int>& next, int head, Probe& probe) {
+    int prev = -1, curr = head;
+    while (curr >= 0) {
+        probe.read(&next[curr], 4);
+        int nx = next[curr];
+        probe.write(&next[curr], 4);
+        next[curr] = prev;
+        prev = curr;
+        curr = nx;
+        probe.endOp();
+    }
+    return prev;
+}
+
+Node* link(const vector<Node*>& order) {
+    for (size_t i = 0; i + 1 < order.size(); i++) order[i]->next = order[i + 1];
+    order.back()->next = nullptr;
+    return order[0];
+}
+
+// two reversals: the first warms the caches up, the second is counted
+Row reverseRow(const string& name, Node* head, size_t length) {
+    AddressTrace trace;
+    head = reverse(head, trace);
+    head = reverse(head, trace);
+    NullProbe none;
+    auto start = chrono::high_resolution_clock::now();
+    head = reverse(head, none);
+    double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - start).count() / length;
+    return {name, simulate(trace, HierarchyConfig::desktop(), length), ns};
+}
+
+void reverseLayouts() {
+    const size_t length = 1 << 21;
+    mt19937 rng(8);
+    vector<Row> rows;
+
+    vector<unique_ptr<Node>> heap;
+    vector<Node*> order;
+    for (size_t i = 0; i < length; i++) {
+        heap.emplace_back(new Node(i));
+        order.push_back(heap.back().get());
+    }
+    rows.push_back(reverseRow("new, list order", link(order), length));
+    shuffle(order.begin(), order.end(), rng);
+    rows.push_back(reverseRow("new, shuffled (aged heap)", link(order), length));
+
+    vector<Node> arena(length, Node(0));
+    order.clear();
+    for (auto& node : arena) order.push_back(&node);
+    rows.push_back(reverseRow("arena, list order", link(order), length));
+
+    // 64-node blocks, in list order inside a block, blocks shuffled
+    const size_t BLOCK = 64;
+    vector<size_t> blocks(length / BLOCK);
+    iota(blocks.begin(), blocks.end(), 0);
+    shuffle(blocks.begin(), blocks.end(), rng);
+    order.clear();
+    for (size_t b : blocks) {
+        for (size_t i = 0; i < BLOCK; i++) order.push_back(&arena[b * BLOCK + i]);
+    }
+    rows.push_back(reverseRow("arena, 64-node blocks", link(order), length));
+
+    vector<int> next(length);
+    for (size_t i = 0; i < length; i++) next[i] = i + 1 < length ? i + 1 : -1;
+    AddressTrace trace;
+    int head = reverseIndexed(next, 0, trace);
+    head = reverseIndexed(next, head, trace);
+    NullProbe none;
+    auto start = chrono::high_resolution_clock::now();
+    reverseIndexed(next, head, none);
+    double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - start).count() / length;
+    rows.push_back({"next[] indices (SoA)", simulate(trace, HierarchyConfig::desktop(), length), ns});
+
+    cout << "Reverse of a 2^21-node list, per next hop (second of two reversals):" << endl;
+    printRows(rows);
+}
+
+int main() {
+    // calibration: a sequential sweep over 64 MB touches a new line every 16 ints
+    {
+        vector<int> a(16 << 20);
+        AddressTrace trace;
+        for (auto& x : a) {
+            trace.read(&x, 4);
+            trace.endOp();
+        }
+        SimResult r = simulate(trace);
+        cout << "Sequential int sweep over 64 MB: " << r.perOp(r.misses[0]) << " L1d misses per access (expect 1/16 = "
+             << 1.0 / 16 << ")" << endl
+             << endl;
+
+        // the same result after a round trip through a file
+        trace.save("/tmp/cachesim_demo.adrt");
+        SimResult again = simulate(AddressTrace::load("/tmp/cachesim_demo.adrt"));
+        remove("/tmp/cachesim_demo.adrt");
+        if (again.misses != r.misses) cout << "saved trace replays DIFFERENTLY" << endl;
+    }
+    unionFindLayouts();
+    cout << endl;
+    reverseLayouts();
+    return 0;
+}
@@ -0,0 +1,348 @@
+#include <bits/stdc++.h>
+#include "../UnionFind/UnionFind.cpp"
+using namespace std;
+
+// Compact binary operation traces for union-find and linked-list workloads.
+//
+// A trace captures *what* a program asked the data structure to do, not the
+// data itself, so it can leave an environment where the data cannot.
+//
+// File layout: "OPTR", one version byte, then records. A record is one op
+// byte followed by its arguments as LEB128 varints:
+//   UF_INIT n                 start a fresh UnionFind of n elements
+//   UF_UNION u v
+//   UF_FIND u
+//   UF_CONNECTED u v          op byte carries the recorded answer in bit 7
+//   LIST_NEW                  new empty list; lists are numbered 0, 1, ...
+//   LIST_PUSH list value      append
+//   LIST_REVERSE list
+//   LIST_HAS_CYCLE list       answer in bit 7
+//   LIST_ATTACH a b pos       a's tail -> node `pos` of b (shared suffix); no-op past b's end
+//   LIST_INTERSECT a b        answer in bit 7
+// Element ids (u, v) are written as the zigzag delta from the previous element
+// id, so local access patterns cost one byte per id. Values are zigzagged.
+// Recorded answers let a replay check that the variant under test agrees.
+// As with the originals in LinkedList/, reverse and intersect assume the
+// lists involved are acyclic; only the cycle check is safe on a closed list.
+
+enum TraceOp : uint8_t {
+    UF_INIT = 1,
+    UF_UNION,
+    UF_FIND,
+    UF_CONNECTED,
+    LIST_NEW,
+    LIST_PUSH,
+    LIST_REVERSE,
+    LIST_HAS_CYCLE,
+    LIST_ATTACH,
+    LIST_INTERSECT,
+};
+
+const uint8_t TRACE_ANSWER = 0x80;
+const uint8_t TRACE_VERSION = 1;
+
+struct TraceRecord {
+    TraceOp op;
+    bool answer;  // for ops that record one
+    long long a, b, c;
+};
+
+class TraceWriter {
+   private:
+    FILE* out;
+    vector<uint8_t> buf;
+    long long prevElement = 0;
+    long long records = 0, bytes = 0;
+
+    void varint(uint64_t x) {
+        while (x >= 0x80) {
+            buf.push_back((uint8_t)x | 0x80);
+            x >>= 7;
+        }
+        buf.push_back((uint8_t)x);
+    }
+
+    static uint64_t zigzag(long long x) { return ((uint64_t)x << 1) ^ (uint64_t)(x >> 63); }
+
+    void element(long long x) {
+        varint(zigzag(x - prevElement));
+        prevElement = x;
+    }
+
+    void op(TraceOp o, bool answer = false) {
+        if (buf.size() >= (1 << 16)) flush();
+        buf.push_back(o | (answer ? TRACE_ANSWER : 0));
+        records++;
+    }
+
+   public:
+    TraceWriter(const string& path) : out(fopen(path.c_str(), "wb")) {
+        if (!out) throw runtime_error("cannot create " + path);
+        const uint8_t header[] = {'O', 'P', 'T', 'R', TRACE_VERSION};
+        buf.assign(header, header + sizeof(header));
+    }
+
+    // a destructor must not throw, so a failed write is reported on stderr;
+    // call close() first to handle it
+    ~TraceWriter() {
+        try {
+            close();
+        } catch (const exception& e) {
+            cerr << "TraceWriter: " << e.what() << " on close; the trace is incomplete" << endl;
+        }
+    }
+
+    void flush() {
+        if (buf.empty()) return;
+        if (fwrite(buf.data(), 1, buf.size(), out) != buf.size()) throw runtime_error("trace write failed");
+        bytes += buf.size();
+        buf.clear();
+    }
+
+    // flush and close the file; throws if either fails
+    void close() {
+        if (!out) return;
+        FILE* f = out;
+        out = nullptr;
+        bool written = buf.empty() || fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+        if (written) bytes += buf.size();
+        buf.clear();
+        if (fclose(f) != 0 || !written) throw runtime_error("trace write failed");
+    }
+
+    void ufInit(int n) {
+        op(UF_INIT);
+        varint(n);
+        prevElement = 0;
+    }
+    void ufUnion(int u, int v) {
+        op(UF_UNION);
+        element(u);
+        element(v);
+    }
+    void ufFind(int u) {
+        op(UF_FIND);
+        element(u);
+    }
+    void ufConnected(int u, int v, bool answer) {
+        op(UF_CONNECTED, answer);
+        element(u);
+        element(v);
+    }
+    void listNew() { op(LIST_NEW); }
+    void listPush(int list, int value) {
+        op(LIST_PUSH);
+        varint(list);
+        varint(zigzag(value));
+    }
+    void listReverse(int list) {
+        op(LIST_REVERSE);
+        varint(list);
+    }
+    void listHasCycle(int list, bool answer) {
+        op(LIST_HAS_CYCLE, answer);
+        varint(list);
+    }
+    void listAttach(int a, int b, int pos) {
+        op(LIST_ATTACH);
+        varint(a);
+        varint(b);
+        varint(pos);
+    }
+    void listIntersect(int a, int b, bool answer) {
+        op(LIST_INTERSECT, answer);
+        varint(a);
+        varint(b);
+    }
+
+    long long recordCount() const { return records; }
+    long long byteCount() const { return bytes + buf.size(); }
+};
+
+// Decodes a whole trace into memory, so replay timing excludes decoding.
+vector<TraceRecord> readTrace(const string& path) {
+    ifstream in(path, ios::binary);
+    vector<uint8_t> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    if (data.size() < 5 || memcmp(data.data(), "OPTR", 4) != 0) throw runtime_error(path + ": not a trace");
+    if (data[4] != TRACE_VERSION) throw runtime_error(path + ": unsupported trace version");
+
+    size_t pos = 5;
+    auto varint = [&]() {
+        uint64_t x = 0;
+        for (int shift = 0;; shift += 7) {
+            if (pos >= data.size() || shift > 63) throw runtime_error(path + ": truncated varint");
+            uint8_t byte = data[pos++];
+            x |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return x;
+        }
+    };
+    auto unzigzag = [](uint64_t x) { return (long long)(x >> 1) ^ -(long long)(x & 1); };
+    long long prevElement = 0;
+    auto element = [&]() { return prevElement += unzigzag(varint()); };
+
+    vector<TraceRecord> records;
+    while (pos < data.size()) {
+        uint8_t byte = data[pos++];
+        TraceRecord r{(TraceOp)(byte & ~TRACE_ANSWER), (byte & TRACE_ANSWER) != 0, 0, 0, 0};
+        switch (r.op) {
+            case UF_INIT:
+                r.a = varint();
+                prevElement = 0;
+                break;
+            case UF_UNION:
+            case UF_CONNECTED:
+                r.a = element();
+                r.b = element();
+                break;
+            case UF_FIND:
+                r.a = element();
+                break;
+            case LIST_NEW:
+                break;
+            case LIST_PUSH:
+                r.a = varint();
+                r.b = unzigzag(varint());
+                break;
+            case LIST_REVERSE:
+            case LIST_HAS_CYCLE:
+                r.a = varint();
+                break;
+            case LIST_ATTACH:
+                r.a = varint();
+                r.b = varint();
+                r.c = varint();
+                break;
+            case LIST_INTERSECT:
+                r.a = varint();
+                r.b = varint();
+                break;
+            default:
+                throw runtime_error(path + ": unknown op " + to_string(byte) + " at byte " + to_string(pos - 1));
+        }
+        records.push_back(r);
+    }
+    return records;
+}
+
+// UnionFind that records every call.
+class TracedUnionFind {
+   private:
+    UnionFind uf;
+    TraceWriter& trace;
+
+   public:
+    TracedUnionFind(int n, TraceWriter& trace) : uf(n), trace(trace) { trace.ufInit(n); }
+
+    void unionSets(int u, int v) {
+        trace.ufUnion(u, v);
+        uf.unionSets(u, v);
+    }
+
+    int find(int u) {
+        trace.ufFind(u);
+        return uf.find(u);
+    }
+
+    bool connected(int u, int v) {
+        bool answer = uf.connected(u, v);
+        trace.ufConnected(u, v, answer);
+        return answer;
+    }
+};
+
+// Singly linked lists of the LinkedList/ Node shape, addressed by list id,
+// with the operations of Reverse.cpp, CycleDetection.cpp and intersection.cpp.
+struct ListNode {
+    int data;
+    ListNode* next;
+    ListNode(int v) : data(v), next(nullptr) {}
+};
+
+class TracedLists {
+   private:
+    vector<ListNode*> heads, tails;
+    vector<unique_ptr<ListNode>> owned;
+    TraceWriter& trace;
+
+   public:
+    TracedLists(TraceWriter& trace) : trace(trace) {}
+
+    int newList() {
+        trace.listNew();
+        heads.push_back(nullptr);
+        tails.push_back(nullptr);
+        return heads.size() - 1;
+    }
+
+    void push(int list, int value) {
+        trace.listPush(list, value);
+        owned.emplace_back(new ListNode(value));
+        ListNode* node = owned.back().get();
+        if (tails[list]) {
+            tails[list]->next = node;
+        } else {
+            heads[list] = node;
+        }
+        tails[list] = node;
+    }
+
+    void reverse(int list) {
+        trace.listReverse(list);
+        ListNode *prev = nullptr, *curr = heads[list];
+        tails[list] = curr;
+        while (curr) {
+            ListNode* next = curr->next;
+            curr->next = prev;
+            prev = curr;
+            curr = next;
+        }
+        heads[list] = prev;
+    }
+
+    bool hasCycle(int list) {
+        ListNode *slow = heads[list], *fast = heads[list];
+        bool answer = false;
+        while (fast && fast->next) {
+            slow = slow->next;
+            fast = fast->next->next;
+            if (slow == fast) {
+                answer = true;
+                break;
+            }
+        }
+        trace.listHasCycle(list, answer);
+        return answer;
+    }
+
+    // a's tail now continues into b at position pos, so both lists share that suffix
+    // (pos past b's end attaches nothing and leaves a as it was)
+    void attach(int a, int b, int pos) {
+        trace.listAttach(a, b, pos);
+        ListNode* at = heads[b];
+        for (int i = 0; i < pos && at; i++) at = at->next;
+        if (!at) return;
+        if (tails[a]) {
+            tails[a]->next = at;
+        } else {
+            heads[a] = at;
+        }
+        tails[a] = tails[b];
+    }
+
+    bool intersect(int a, int b) {
+        // length-difference walk, O(1) extra space
+        auto length = [](ListNode* p) {
+            int len = 0;
+            for (; p; p = p->next) len++;
+            return len;
+        };
+        ListNode *p = heads[a], *q = heads[b];
+        int la = length(p), lb = length(q);
+        for (; la > lb; la--) p = p->next;
+        for (; lb > la; lb--) q = q->next;
+        while (p != q) p = p->next, q = q->next;
+        bool answer = p != nullptr;
+        trace.listIntersect(a, b, answer);
+        return answer;
+    }
+};
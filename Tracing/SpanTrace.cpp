@@ -0,0 +1,176 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Per-thread phase spans written as Chrome trace JSON, for chrome://tracing or
+// ui.perfetto.dev.
+//
+//   SPAN("partition");              times the rest of the enclosing scope
+//   SPAN_THREAD_NAME("worker");     labels the calling thread's track
+//   SPAN_TRACE_WRITE("run.json");   writes every span recorded so far
+//
+// All three expand to nothing unless SPAN_TRACE is defined, so instrumented
+// code builds exactly as before without -DSPAN_TRACE.
+//
+// Each thread records into its own ring of SPAN_RING_EVENTS spans: a span is
+// two clock reads and one store, with no lock and no allocation. When a ring
+// is full the oldest spans are overwritten and counted as dropped. Names are
+// kept by pointer, so they must be string literals.
+//
+// A ring is taken from a shared pool at a thread's first span and handed back
+// when the thread exits, with its spans intact. The pool therefore holds as
+// many rings as threads were ever alive at once, and a thread pool that is
+// rebuilt for every phase keeps reusing the same tracks (one per worker slot).
+// SPAN_TRACE_WRITE reads all rings without synchronising with their writers:
+// call it only while no other thread is recording, e.g. after the joins.
+
+#ifdef SPAN_TRACE
+
+#ifndef SPAN_RING_EVENTS
+#define SPAN_RING_EVENTS (1 << 15)
+#endif
+
+namespace span_detail {
+
+static_assert((SPAN_RING_EVENTS & (SPAN_RING_EVENTS - 1)) == 0, "SPAN_RING_EVENTS must be a power of two");
+
+struct Event {
+    const char* name;
+    uint64_t startNs, durNs;
+};
+
+struct Ring {
+    int track;
+    string threadName;
+    uint64_t recorded = 0;  // total ever; the ring keeps the last SPAN_RING_EVENTS
+    vector<Event> events;
+
+    Ring(int track) : track(track), threadName("thread " + to_string(track)), events(SPAN_RING_EVENTS) {}
+};
+
+struct Registry {
+    mutex lock;
+    vector<unique_ptr<Ring>> rings;
+    vector<Ring*> idle;
+    chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+};
+
+// never destroyed: threads may still hand rings back during static destruction
+inline Registry& registry() {
+    static Registry* r = new Registry();
+    return *r;
+}
+
+inline uint64_t now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - registry().epoch).count();
+}
+
+struct RingHolder {
+    Ring* ring = nullptr;
+
+    ~RingHolder() {
+        if (!ring) return;
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        r.idle.push_back(ring);
+    }
+};
+
+inline Ring& localRing() {
+    thread_local RingHolder holder;
+    if (!holder.ring) {
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        if (!r.idle.empty()) {
+            holder.ring = r.idle.back();
+            r.idle.pop_back();
+        } else {
+            r.rings.emplace_back(new Ring(r.rings.size()));
+            holder.ring = r.rings.back().get();
+        }
+    }
+    return *holder.ring;
+}
+
+class SpanScope {
+   private:
+    Ring& ring;
+    const char* name;
+    uint64_t start;
+
+   public:
+    SpanScope(const char* name) : ring(localRing()), name(name), start(now()) {}
+    SpanScope(const SpanScope&) = delete;
+    SpanScope& operator=(const SpanScope&) = delete;
+
+    ~SpanScope() {
+        uint64_t end = now();
+        ring.events[ring.recorded++ & (SPAN_RING_EVENTS - 1)] = {name, start, end - start};
+    }
+};
+
+inline void nameThread(const string& name) { localRing().threadName = name; }
+
+inline void writeJsonString(FILE* out, const string& s) {
+    fputc('"', out);
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if ((unsigned char)c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+// timestamps in microseconds, as the format expects, with nanosecond decimals
+inline void write(const string& path) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) throw runtime_error("cannot create " + path);
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    uint64_t dropped = 0;
+    bool first = true;
+    auto separator = [&]() {
+        fputs(first ? "\n" : ",\n", out);
+        first = false;
+    };
+    fputs("{\"traceEvents\":[", out);
+    for (auto& ring : r.rings) {
+        separator();
+        fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", ring->track);
+        writeJsonString(out, ring->threadName);
+        fputs("}}", out);
+        uint64_t kept = min<uint64_t>(ring->recorded, SPAN_RING_EVENTS);
+        dropped += ring->recorded - kept;
+        for (uint64_t i = ring->recorded - kept; i < ring->recorded; i++) {
+            const Event& e = ring->events[i & (SPAN_RING_EVENTS - 1)];
+            separator();
+            fputs("{\"name\":", out);
+            writeJsonString(out, e.name);
+            fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%llu.%03llu,\"dur\":%llu.%03llu}", ring->track,
+                    (unsigned long long)(e.startNs / 1000), (unsigned long long)(e.startNs % 1000),
+                    (unsigned long long)(e.durNs / 1000), (unsigned long long)(e.durNs % 1000));
+        }
+    }
+    fprintf(out, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedSpans\":%llu}}\n", (unsigned long long)dropped);
+    if (fclose(out) != 0) throw runtime_error("trace write failed");
+}
+
+}
+
+#define SPAN_CONCAT_(a, b) a##b
+#define SPAN_CONCAT(a, b) SPAN_CONCAT_(a, b)
+#define SPAN(name) span_detail::SpanScope SPAN_CONCAT(spanScope_, __LINE__)(name)
+#define SPAN_THREAD_NAME(name) span_detail::nameThread(name)
+#define SPAN_TRACE_WRITE(path) span_detail::write(path)
+
+#else
+
+#define SPAN(name) ((void)0)
+#define SPAN_THREAD_NAME(name) ((void)0)
+#define SPAN_TRACE_WRITE(path) ((void)0)
+
+#endif
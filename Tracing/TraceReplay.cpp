@@ -0,0 +1,310 @@
+#include <bits/stdc++.h>
+#include "OpTrace.cpp"
+using namespace std;
+
+// Replays an operation trace (see OpTrace.cpp) against a data-structure
+// variant and reports throughput, per-op latency and whether the recorded
+// answers were reproduced.
+//
+//   TraceReplay              record a synthetic workload to a temp file, then replay it
+//   TraceReplay <trace>      replay an existing trace
+//
+// A variant is any type with the Target interface below. Throughput comes
+// from an untimed-per-op pass; latency from a second pass on a fresh target
+// that times every 64th op individually (clock overhead subtracted).
+
+// what the trace was recorded on: UnionFind + heap-allocated list nodes
+struct BaselineTarget {
+    static string name() { return "UnionFind + heap nodes"; }
+
+    unique_ptr<UnionFind> uf;
+    vector<ListNode*> heads, tails;
+    vector<unique_ptr<ListNode>> owned;
+
+    void ufInit(int n) { uf.reset(new UnionFind(n)); }
+    void ufUnion(int u, int v) { uf->unionSets(u, v); }
+    int ufFind(int u) { return uf->find(u); }
+    bool ufConnected(int u, int v) { return uf->connected(u, v); }
+
+    void listNew() {
+        heads.push_back(nullptr);
+        tails.push_back(nullptr);
+    }
+    void listPush(int list, int value) {
+        owned.emplace_back(new ListNode(value));
+        ListNode* node = owned.back().get();
+        (tails[list] ? tails[list]->next : heads[list]) = node;
+        tails[list] = node;
+    }
+    void listReverse(int list) {
+        ListNode *prev = nullptr, *curr = heads[list];
+        tails[list] = curr;
+        while (curr) {
+            ListNode* next = curr->next;
+            curr->next = prev;
+            prev = curr;
+            curr = next;
+        }
+        heads[list] = prev;
+    }
+    bool listHasCycle(int list) {
+        ListNode *slow = heads[list], *fast = heads[list];
+        while (fast && fast->next) {
+            slow = slow->next;
+            fast = fast->next->next;
+            if (slow == fast) return true;
+        }
+        return false;
+    }
+    void listAttach(int a, int b, int pos) {
+        ListNode* at = heads[b];
+        for (int i = 0; i < pos && at; i++) at = at->next;
+        if (!at) return;  // past b's end: nothing to share, as in TracedLists
+        (tails[a] ? tails[a]->next : heads[a]) = at;
+        tails[a] = tails[b];
+    }
+    bool listIntersect(int a, int b) {
+        auto length = [](ListNode* p) {
+            int len = 0;
+            for (; p; p = p->next) len++;
+            return len;
+        };
+        ListNode *p = heads[a], *q = heads[b];
+        int la = length(p), lb = length(q);
+        for (; la > lb; la--) p = p->next;
+        for (; lb > la; lb--) q = q->next;
+        while (p != q) p = p->next, q = q->next;
+        return p != nullptr;
+    }
+};
+
+// a candidate: iterative halving + union by size, list nodes as indices into one arena
+struct ArenaTarget {
+    static string name() { return "halving/size UF + node arena"; }
+
+    vector<int> parent, size;
+    vector<int> data, next;  // arena; -1 = null
+    vector<int> heads, tails;
+
+    void ufInit(int n) {
+        parent.resize(n);
+        iota(parent.begin(), parent.end(), 0);
+        size.assign(n, 1);
+    }
+    int ufFind(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+    void ufUnion(int u, int v) {
+        int ru = ufFind(u), rv = ufFind(v);
+        if (ru == rv) return;
+        if (size[ru] < size[rv]) swap(ru, rv);
+        parent[rv] = ru;
+        size[ru] += size[rv];
+    }
+    bool ufConnected(int u, int v) { return ufFind(u) == ufFind(v); }
+
+    void listNew() {
+        heads.push_back(-1);
+        tails.push_back(-1);
+    }
+    void listPush(int list, int value) {
+        data.push_back(value);
+        next.push_back(-1);
+        int node = data.size() - 1;
+        (tails[list] >= 0 ? next[tails[list]] : heads[list]) = node;
+        tails[list] = node;
+    }
+    void listReverse(int list) {
+        int prev = -1, curr = heads[list];
+        tails[list] = curr;
+        while (curr >= 0) {
+            int nx = next[curr];
+            next[curr] = prev;
+            prev = curr;
+            curr = nx;
+        }
+        heads[list] = prev;
+    }
+    bool listHasCycle(int list) {
+        int slow = heads[list], fast = heads[list];
+        while (fast >= 0 && next[fast] >= 0) {
+            slow = next[slow];
+            fast = next[next[fast]];
+            if (slow == fast) return true;
+        }
+        return false;
+    }
+    void listAttach(int a, int b, int pos) {
+        int at = heads[b];
+        for (int i = 0; i < pos && at >= 0; i++) at = next[at];
+        if (at < 0) return;
+        (tails[a] >= 0 ? next[tails[a]] : heads[a]) = at;
+        tails[a] = tails[b];
+    }
+    bool listIntersect(int a, int b) {
+        auto length = [&](int p) {
+            int len = 0;
+            for (; p >= 0; p = next[p]) len++;
+            return len;
+        };
+        int p = heads[a], q = heads[b];
+        int la = length(p), lb = length(q);
+        for (; la > lb; la--) p = next[p];
+        for (; lb > la; lb--) q = next[q];
+        while (p != q) p = next[p], q = next[q];
+        return p >= 0;
+    }
+};
+
+// returns 0/1 for ops that record an answer, -1 otherwise
+template <class Target>
+inline int apply(Target& t, const TraceRecord& r, long long& sink) {
+    switch (r.op) {
+        case UF_INIT: t.ufInit(r.a); return -1;
+        case UF_UNION: t.ufUnion(r.a, r.b); return -1;
+        case UF_FIND: sink += t.ufFind(r.a); return -1;
+        case UF_CONNECTED: return t.ufConnected(r.a, r.b);
+        case LIST_NEW: t.listNew(); return -1;
+        case LIST_PUSH: t.listPush(r.a, r.b); return -1;
+        case LIST_REVERSE: t.listReverse(r.a); return -1;
+        case LIST_HAS_CYCLE: return t.listHasCycle(r.a);
+        case LIST_ATTACH: t.listAttach(r.a, r.b, r.c); return -1;
+        case LIST_INTERSECT: return t.listIntersect(r.a, r.b);
+    }
+    return -1;
+}
+
+const char* opName(TraceOp op) {
+    static const char* names[] = {"?", "uf init", "uf union", "uf find", "uf connected", "list new",
+                                  "list push", "list reverse", "list has-cycle", "list attach", "list intersect"};
+    return op <= LIST_INTERSECT ? names[op] : "?";
+}
+
+template <class Target>
+void replay(const vector<TraceRecord>& trace) {
+    const int SAMPLE_EVERY = 64;
+    long long sink = 0, mismatches = 0;
+
+    // pass 1: throughput
+    {
+        Target t;
+        auto start = chrono::steady_clock::now();
+        for (const TraceRecord& r : trace) {
+            int answer = apply(t, r, sink);
+            if (answer >= 0 && answer != r.answer) mismatches++;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << Target::name() << ": " << (long long)(trace.size() / seconds) << " ops/s, "
+             << mismatches << " answers differ from the recording" << endl;
+    }
+
+    // pass 2: sampled latency per op kind
+    long long overhead;
+    {
+        vector<long long> empty(1001);
+        for (auto& e : empty) {
+            auto a = chrono::steady_clock::now();
+            auto b = chrono::steady_clock::now();
+            e = chrono::duration_cast<chrono::nanoseconds>(b - a).count();
+        }
+        nth_element(empty.begin(), empty.begin() + 500, empty.end());
+        overhead = empty[500];
+    }
+    map<int, vector<long long>> latency;
+    Target t;
+    for (size_t i = 0; i < trace.size(); i++) {
+        if (i % SAMPLE_EVERY) {
+            apply(t, trace[i], sink);
+            continue;
+        }
+        auto a = chrono::steady_clock::now();
+        apply(t, trace[i], sink);
+        auto b = chrono::steady_clock::now();
+        latency[trace[i].op].push_back(max(0LL, (long long)chrono::duration_cast<chrono::nanoseconds>(b - a).count() - overhead));
+    }
+    for (auto& [op, ns] : latency) {
+        sort(ns.begin(), ns.end());
+        auto pct = [&](double p) { return ns[min(ns.size() - 1, (size_t)(p * ns.size()))]; };
+        cout << "    " << left << setw(15) << opName((TraceOp)op) << right << " p50 " << setw(7) << pct(0.5)
+             << " ns  p99 " << setw(8) << pct(0.99) << " ns  p99.9 " << setw(9) << pct(0.999) << " ns  ("
+             << ns.size() << " samples)" << endl;
+    }
+    if (sink == -1) cout << endl;
+}
+
+// a synthetic stand-in for a production run: clustered unions with bursts of
+// connectivity queries, plus three pools of lists:
+//   0..63     built and reversed
+//   64..127   built and made to share suffixes. Only a list no other list
+//             shares may be attached, and a list is frozen (no more pushes or
+//             attaches of its tail) once it shares a suffix either way, so
+//             recorded tails and lengths stay exact and the chains acyclic
+//   128..191  built and sometimes closed into a cycle; only cycle checks read them
+void recordSynthetic(const string& path) {
+    TraceWriter w(path);
+    const int n = 1 << 20, POOL = 64;
+    mt19937 rng(42);
+    TracedUnionFind uf(n, w);
+    TracedLists lists(w);
+    for (int i = 0; i < 3 * POOL; i++) lists.newList();
+    vector<int> lengths(3 * POOL, 0);
+    vector<char> shared(3 * POOL, 0);  // pool 64..127 only
+
+    for (int step = 0; step < 2000000; step++) {
+        int r = rng() % 100;
+        int base = rng() % n;
+        if (r < 40) {
+            uf.unionSets(base, min(n - 1, base + (int)(rng() % 256)));
+        } else if (r < 70) {
+            uf.connected(base, rng() % 2 ? (int)(rng() % n) : min(n - 1, base + (int)(rng() % 64)));
+        } else if (r < 85) {
+            uf.find(base);
+        } else if (r < 98) {
+            int l = rng() % (3 * POOL);
+            if (!shared[l]) {
+                lists.push(l, rng() % 1000);
+                lengths[l]++;
+            }
+        } else if (r < 99) {
+            lists.reverse(rng() % POOL);
+        } else {
+            int a = POOL + rng() % POOL, b = POOL + rng() % POOL, c = 2 * POOL + rng() % POOL;
+            // a is private, so b's chain cannot reach a's nodes: no cycle
+            if (a != b && !lists.intersect(a, b) && !shared[a] && lengths[b] > 0) {
+                int pos = rng() % lengths[b];
+                lists.attach(a, b, pos);
+                lengths[a] += lengths[b] - pos;
+                shared[a] = shared[b] = 1;
+            }
+            if (lengths[c] > 0 && rng() % 8 == 0) lists.attach(c, c, rng() % lengths[c]);
+            lists.hasCycle(c);
+        }
+    }
+    w.close();
+    cout << "Recorded " << w.recordCount() << " ops in " << w.byteCount() << " bytes ("
+         << fixed << setprecision(2) << (double)w.byteCount() / w.recordCount() << " bytes/op)" << endl;
+    cout.unsetf(ios::floatfield);
+}
+
+int main(int argc, char** argv) {
+    string path;
+    if (argc > 1) {
+        path = argv[1];
+    } else {
+        path = "/tmp/optrace_demo.bin";
+        recordSynthetic(path);
+    }
+    auto start = chrono::high_resolution_clock::now();
+    vector<TraceRecord> trace = readTrace(path);
+    auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+    cout << "Decoded " << trace.size() << " ops in " << ms << " ms" << endl;
+
+    replay<BaselineTarget>(trace);
+    replay<ArenaTarget>(trace);
+    if (argc <= 1) remove(path.c_str());
+    return 0;
+}
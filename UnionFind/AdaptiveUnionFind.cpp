@@ -0,0 +1,363 @@
+#include <bits/stdc++.h>
+#include "UnionFind.cpp"
+using namespace std;
+
+// Union-find that picks its compression strategy from the workload.
+//
+// TunedUnionFind<Link, Compress> is one compile-time specialization:
+//   Link:     LINK_RANK, LINK_SIZE, or LINK_INDEX (u's root adopts v's root,
+//             like unionSets(u, v, false); no auxiliary array)
+//   Compress: COMPRESS_FULL (two-pass), COMPRESS_HALVING, or COMPRESS_NONE
+// LINK_INDEX with COMPRESS_NONE can degrade to linear chains and is not offered.
+//
+// AdaptiveUnionFind chooses between the two rank-linked candidates the demo's
+// workloads ever favoured: rank + halving and rank + no compression. It runs
+// the caller's loop body, `step(uf)`, which performs one operation on `uf`
+// and returns false when there are no more. Until `warmupOps` operations have
+// shaped the forest `uf` is rank + halving; the next `sampleOps` are counted
+// (finds per union, and the average depth of the found elements). With at
+// least 4 finds per union and a depth of at most 0.5 it switches to no
+// compression, otherwise it stays on halving. Both link by rank, so the
+// switch moves the parent and rank arrays over once. `step` is instantiated
+// for each specialization, so after the switch every operation runs on the
+// chosen type directly, with no per-call branch or dispatch.
+
+enum LinkPolicy { LINK_RANK, LINK_SIZE, LINK_INDEX };
+enum CompressPolicy { COMPRESS_FULL, COMPRESS_HALVING, COMPRESS_NONE };
+
+template <LinkPolicy L, CompressPolicy C>
+class TunedUnionFind {
+    static_assert(!(L == LINK_INDEX && C == COMPRESS_NONE), "index linking needs compression");
+
+   private:
+    vector<int> parent, aux;  // aux = rank or size; unused for LINK_INDEX
+
+   public:
+    TunedUnionFind(int n) : parent(n), aux(L == LINK_INDEX ? 0 : n, L == LINK_SIZE ? 1 : 0) {
+        iota(parent.begin(), parent.end(), 0);
+    }
+
+    // take over another rank-linked forest's arrays
+    TunedUnionFind(vector<int>&& parent, vector<int>&& rank) : parent(move(parent)), aux(move(rank)) {
+        static_assert(L == LINK_RANK, "only rank-linked forests move between policies");
+    }
+
+    pair<vector<int>, vector<int>> release() { return {move(parent), move(aux)}; }
+
+    int find(int x) {
+        if constexpr (C == COMPRESS_NONE) {
+            while (parent[x] != x) x = parent[x];
+            return x;
+        } else if constexpr (C == COMPRESS_HALVING) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        } else {
+            int r = x;
+            while (parent[r] != r) r = parent[r];
+            while (parent[x] != r) {
+                int next = parent[x];
+                parent[x] = r;
+                x = next;
+            }
+            return r;
+        }
+    }
+
+    // hops from x to its root, without compressing
+    int depth(int x) const {
+        int d = 0;
+        for (; parent[x] != x; x = parent[x]) d++;
+        return d;
+    }
+
+    void unionSets(int u, int v) {
+        int ru = find(u), rv = find(v);
+        if (ru == rv) return;
+        if constexpr (L == LINK_RANK) {
+            if (aux[ru] < aux[rv]) swap(ru, rv);
+            if (aux[ru] == aux[rv]) aux[ru]++;
+        } else if constexpr (L == LINK_SIZE) {
+            if (aux[ru] < aux[rv]) swap(ru, rv);
+            aux[ru] += aux[rv];
+        }
+        parent[rv] = ru;
+    }
+
+    bool connected(int u, int v) { return find(u) == find(v); }
+
+    int size() const { return parent.size(); }
+
+    static string name() {
+        static const char* links[] = {"rank", "size", "index"};
+        static const char* compressions[] = {"full compression", "halving", "no compression"};
+        return string(links[L]) + " + " + compressions[C];
+    }
+};
+
+volatile long long blackhole;  // keeps timed find() results alive
+
+struct AdaptiveReport {
+    long long unions = 0, finds = 0;  // in the sample; connected() counts as two finds
+    double averageDepth = 0;          // hops per find in the sample, under rank + halving
+    double overheadMs = 0;            // sampling and switching, not the operations themselves
+    string chosen;
+};
+
+class AdaptiveUnionFind {
+   public:
+    typedef TunedUnionFind<LINK_RANK, COMPRESS_HALVING> Halving;
+    typedef TunedUnionFind<LINK_RANK, COMPRESS_NONE> NoCompression;
+
+    // what `step` sees before the switch: rank + halving, counting the sample
+    class Sampler {
+       private:
+        AdaptiveUnionFind& a;
+        Halving& uf;
+
+       public:
+        Sampler(AdaptiveUnionFind& a) : a(a), uf(get<0>(a.impl)) {}
+        int find(int x) {
+            a.observe(uf, 1, x, x);
+            return uf.find(x);
+        }
+        void unionSets(int u, int v) {
+            a.observe(uf, 0, u, v);
+            uf.unionSets(u, v);
+        }
+        bool connected(int u, int v) {
+            a.observe(uf, 2, u, v);
+            return uf.connected(u, v);
+        }
+        int size() const { return uf.size(); }
+    };
+
+   private:
+    variant<Halving, NoCompression> impl;
+    size_t warmupOps, sampleOps, seen = 0;
+    bool decided = false;
+    long long hops = 0;
+    AdaptiveReport rep;
+
+    typedef chrono::steady_clock Clock;
+
+    // x/y are the elements found; nothing is found for a union
+    void observe(const Halving& uf, int finds, int x, int y) {
+        if (++seen <= warmupOps || seen > warmupOps + sampleOps) return;
+        auto start = Clock::now();
+        if (finds == 0) {
+            rep.unions++;
+        } else {
+            rep.finds += finds;
+            hops += uf.depth(x);
+            if (finds == 2) hops += uf.depth(y);
+        }
+        rep.overheadMs += chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+   public:
+    AdaptiveUnionFind(int n, size_t warmupOps = 0, size_t sampleOps = 1 << 16)
+        : impl(in_place_index<0>, n), warmupOps(warmupOps), sampleOps(sampleOps) {}
+
+    // call step(uf) until it returns false; can be called again to continue
+    template <class Step>
+    void run(Step&& step) {
+        if (!decided) {
+            Sampler sampler(*this);
+            while (seen < warmupOps + sampleOps) {
+                if (!step(sampler)) return;
+            }
+            decide();
+        }
+        std::visit([&](auto& uf) {
+            while (step(uf)) {}
+        }, impl);
+    }
+
+    // end the sample now and commit to a specialization
+    void decide() {
+        if (decided) return;
+        decided = true;
+        auto start = Clock::now();
+        rep.averageDepth = rep.finds ? (double)hops / rep.finds : 0;
+        if (rep.finds >= 4 * rep.unions && rep.averageDepth <= 0.5) {
+            auto arrays = get<0>(impl).release();
+            impl.emplace<1>(move(arrays.first), move(arrays.second));
+        }
+        rep.chosen = std::visit([](auto& uf) { return uf.name(); }, impl);
+        rep.overheadMs += chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    // run f on the current specialization
+    template <class F>
+    decltype(auto) visit(F&& f) {
+        return std::visit(forward<F>(f), impl);
+    }
+
+    const AdaptiveReport& report() const { return rep; }
+};
+
+// ---- workloads -------------------------------------------------------------
+
+struct LoggedOp {
+    enum Kind : uint8_t { UNION, FIND, CONNECTED } kind;
+    int u, v;
+};
+
+struct Workload {
+    string name;
+    int n;
+    vector<LoggedOp> ops;
+};
+
+Workload randomMixed(int n, long long m) {
+    Workload w{"random unions and queries, 1:1", n, {}};
+    mt19937 rng(1);
+    for (long long i = 0; i < m; i++) {
+        LoggedOp::Kind k = i % 2 ? LoggedOp::UNION : LoggedOp::CONNECTED;
+        w.ops.push_back({k, (int)(rng() % n), (int)(rng() % n)});
+    }
+    return w;
+}
+
+Workload queryHeavy(int n, long long m) {
+    Workload w{"few unions, then mostly finds", n, {}};
+    mt19937 rng(2);
+    for (long long i = 0; i < m; i++) {
+        LoggedOp::Kind k = i % 16 ? LoggedOp::FIND : LoggedOp::UNION;
+        w.ops.push_back({k, (int)(rng() % n), (int)(rng() % n)});
+    }
+    return w;
+}
+
+Workload bulkThenFinds(int n, long long m) {
+    // a burst of random unions builds one big, deep forest; then only finds
+    Workload w{"bulk unions, then random finds", n, {}};
+    mt19937 rng(4);
+    for (long long i = 0; i < m; i++) {
+        LoggedOp::Kind k = i < n ? LoggedOp::UNION : LoggedOp::FIND;
+        w.ops.push_back({k, (int)(rng() % n), (int)(rng() % n)});
+    }
+    return w;
+}
+
+Workload binomialThenFinds(int n, long long m) {
+    // unions pair up whole blocks root to root (0-1, 2-3, then 0-2, 4-6, ...),
+    // so nothing gets compressed and rank builds binomial trees of depth
+    // log n; then only finds
+    Workload w{"binomial merges, then random finds", n, {}};
+    for (int step = 1; step < n; step *= 2) {
+        for (int i = 0; i + step < n; i += 2 * step) w.ops.push_back({LoggedOp::UNION, i, i + step});
+    }
+    mt19937 rng(5);
+    while ((long long)w.ops.size() < m) w.ops.push_back({LoggedOp::FIND, (int)(rng() % n), 0});
+    return w;
+}
+
+Workload appendStream(int n, long long m) {
+    // each union attaches a fresh element to a recent one; finds on recent elements
+    Workload w{"streaming appends, local finds", n, {}};
+    mt19937 rng(3);
+    int next = 1;
+    for (long long i = 0; i < m; i++) {
+        if (i % 2 == 0 && next < n) {
+            w.ops.push_back({LoggedOp::UNION, next - 1 - (int)(rng() % min(next, 8)), next});
+            next++;
+        } else {
+            w.ops.push_back({LoggedOp::FIND, max(0, next - 1 - (int)(rng() % 1024)), 0});
+        }
+    }
+    return w;
+}
+
+const int RUNS = 3;  // timings are the best of RUNS
+
+template <class T>
+long long runFixed(const Workload& w) {
+    long long best = LLONG_MAX;
+    for (int run = 0; run < RUNS; run++) {
+        T uf(w.n);
+        long long sink = 0;
+        auto start = chrono::high_resolution_clock::now();
+        for (const LoggedOp& op : w.ops) {
+            if (op.kind == LoggedOp::UNION) {
+                uf.unionSets(op.u, op.v);
+            } else if (op.kind == LoggedOp::FIND) {
+                sink += uf.find(op.u);
+            } else {
+                sink += uf.connected(op.u, op.v);
+            }
+        }
+        auto end = chrono::high_resolution_clock::now();
+        blackhole = sink;
+        best = min(best, (long long)chrono::duration_cast<chrono::milliseconds>(end - start).count());
+    }
+    return best;
+}
+
+long long runAdaptive(const Workload& w, AdaptiveReport& report) {
+    long long best = LLONG_MAX;
+    for (int run = 0; run < RUNS; run++) {
+        // sample a quarter of the way in, once the workload has shaped the forest
+        AdaptiveUnionFind uf(w.n, w.ops.size() / 4);
+        long long sink = 0;
+        auto start = chrono::high_resolution_clock::now();
+        size_t i = 0;
+        uf.run([&](auto& impl) {
+            if (i == w.ops.size()) return false;
+            const LoggedOp& op = w.ops[i++];
+            if (op.kind == LoggedOp::UNION) {
+                impl.unionSets(op.u, op.v);
+            } else if (op.kind == LoggedOp::FIND) {
+                sink += impl.find(op.u);
+            } else {
+                sink += impl.connected(op.u, op.v);
+            }
+            return true;
+        });
+        auto end = chrono::high_resolution_clock::now();
+        blackhole = sink;
+        long long ms = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        if (ms < best) {
+            best = ms;
+            report = uf.report();
+        }
+    }
+    return best;
+}
+
+typedef tuple<TunedUnionFind<LINK_RANK, COMPRESS_HALVING>, TunedUnionFind<LINK_RANK, COMPRESS_FULL>,
+              TunedUnionFind<LINK_RANK, COMPRESS_NONE>, TunedUnionFind<LINK_SIZE, COMPRESS_HALVING>,
+              TunedUnionFind<LINK_SIZE, COMPRESS_FULL>, TunedUnionFind<LINK_SIZE, COMPRESS_NONE>,
+              TunedUnionFind<LINK_INDEX, COMPRESS_HALVING>, TunedUnionFind<LINK_INDEX, COMPRESS_FULL>>
+    AllPolicies;
+
+template <size_t I = 0>
+void runAllFixed(const Workload& w) {
+    if constexpr (I < tuple_size_v<AllPolicies>) {
+        typedef tuple_element_t<I, AllPolicies> T;
+        cout << "    " << left << setw(30) << T::name() << right << setw(6) << runFixed<T>(w) << " ms" << endl;
+        runAllFixed<I + 1>(w);
+    }
+}
+
+int main() {
+    const int n = 1 << 22;
+    const long long m = 1 << 24;
+    for (Workload w : {randomMixed(n, m), queryHeavy(n, m), bulkThenFinds(n, m), binomialThenFinds(n, m), appendStream(n, m)}) {
+        cout << w.name << " (" << w.ops.size() << " ops):" << endl;
+        cout << "    " << left << setw(30) << "UnionFind (rank, recursive)" << right << setw(6) << runFixed<UnionFind>(w)
+             << " ms" << endl;
+        runAllFixed(w);
+
+        AdaptiveReport r;
+        long long ms = runAdaptive(w, r);
+        cout << "    adaptive: " << ms << " ms -> " << r.chosen << " (sample: " << r.unions << " unions, " << r.finds
+             << " finds, average depth " << fixed << setprecision(2) << r.averageDepth << "), of which "
+             << r.overheadMs << " ms sampling and switching" << endl;
+        cout.unsetf(ios::floatfield);
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Concurrent union-find where readers never write.
+//
+// parent[] is an array of atomics. Unions are lock-free: find both roots, then
+// CAS the lower-priority root's self-loop to point at the other root (retry on
+// failure). Priorities are a fixed hash of the index, which keeps expected
+// depth logarithmic without a rank array to keep consistent.
+//
+// Ordinary concurrent union-find compresses paths inside find (path halving
+// with CAS or relaxed stores), so every query may dirty `parent` cache lines
+// that other cores are reading. Here find() is a pure walk. A background
+// compactor thread sweeps the array instead, shortcutting each non-root entry
+// to its current root with relaxed stores. This is safe because:
+//   - only roots are ever CASed by unions, and a non-root never becomes a
+//     root again, so the compactor and the unions never write the same entry;
+//   - the compactor stores an ancestor of i (a root it saw, which may since
+//     have been linked under another root), so i's set membership never
+//     changes.
+// Readers see shallow trees without writing anything.
+
+class ConcurrentUnionFind {
+   private:
+    int n;
+    unique_ptr<atomic<int>[]> parent;
+    bool compressOnRead;
+    atomic<long long> unionCount{0};
+
+    atomic<bool> stopping{false};
+    thread compactor;
+    atomic<long long> passes{0};
+
+    static uint32_t priority(int x) {
+        uint32_t h = x * 0x9E3779B1u;
+        return h ^ (h >> 16);
+    }
+
+    int root(int x) const {
+        int p = parent[x].load(memory_order_relaxed);
+        while (p != x) {
+            x = p;
+            p = parent[x].load(memory_order_relaxed);
+        }
+        return x;
+    }
+
+    // conventional path halving; used only when compressOnRead is set
+    int rootHalving(int x) {
+        while (true) {
+            int p = parent[x].load(memory_order_relaxed);
+            if (p == x) return x;
+            int g = parent[p].load(memory_order_relaxed);
+            if (g != p) parent[x].compare_exchange_weak(p, g, memory_order_relaxed);
+            x = g;
+        }
+    }
+
+    void compactLoop(chrono::microseconds idle) {
+        long long seen = -1;
+        while (!stopping.load(memory_order_relaxed)) {
+            long long now = unionCount.load(memory_order_relaxed);
+            if (now == seen) {
+                this_thread::sleep_for(idle);
+                continue;
+            }
+            seen = now;
+            compactNow();
+        }
+    }
+
+   public:
+    ConcurrentUnionFind(int n, bool compressOnRead = false) : n(n), parent(new atomic<int>[n]), compressOnRead(compressOnRead) {
+        for (int i = 0; i < n; i++) parent[i].store(i, memory_order_relaxed);
+    }
+
+    ~ConcurrentUnionFind() { stopCompactor(); }
+
+    // no-op if the compactor is already running
+    void startCompactor(chrono::microseconds idle = chrono::microseconds(200)) {
+        if (compactor.joinable()) return;
+        stopping = false;
+        compactor = thread([this, idle] { compactLoop(idle); });
+    }
+
+    void stopCompactor() {
+        stopping = true;
+        if (compactor.joinable()) compactor.join();
+    }
+
+    // one flattening sweep; the compactor thread runs these back to back
+    void compactNow() {
+        for (int i = 0; i < n; i++) {
+            int p = parent[i].load(memory_order_relaxed);
+            if (p == i) continue;
+            int r = root(p);
+            if (r != p) parent[i].store(r, memory_order_relaxed);
+        }
+        passes.fetch_add(1, memory_order_relaxed);
+    }
+
+    int find(int x) { return compressOnRead ? rootHalving(x) : root(x); }
+
+    void unionSets(int u, int v) {
+        while (true) {
+            int ru = find(u), rv = find(v);
+            if (ru == rv) return;
+            if (priority(ru) > priority(rv) || (priority(ru) == priority(rv) && ru > rv)) swap(ru, rv);
+            int expected = ru;
+            if (parent[ru].compare_exchange_strong(expected, rv, memory_order_release, memory_order_relaxed)) {
+                unionCount.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    bool connected(int u, int v) {
+        while (true) {
+            int ru = find(u), rv = find(v);
+            if (ru == rv) return true;
+            // ru is still a root, so u and v really were apart at this instant
+            if (parent[ru].load(memory_order_acquire) == ru) return false;
+        }
+    }
+
+    long long compactorPasses() const { return passes.load(); }
+
+    double averageDepth() const {
+        long long total = 0;
+        for (int x = 0; x < n; x++) {
+            for (int y = x; parent[y].load(memory_order_relaxed) != y; y = parent[y].load(memory_order_relaxed)) total++;
+        }
+        return (double)total / n;
+    }
+};
+
+struct RunStats {
+    long long queries;
+    double seconds, depth;
+    long long passes;
+};
+
+// one writer trickles unions in; `readers` threads hammer connected()
+RunStats readMostly(bool compressOnRead, bool useCompactor, int n, int readers, int initialUnions) {
+    ConcurrentUnionFind uf(n, compressOnRead);
+    mt19937 rng(5);
+    for (int i = 0; i < initialUnions; i++) uf.unionSets(rng() % n, rng() % n);
+    if (useCompactor) {
+        uf.compactNow();
+        uf.startCompactor();
+    }
+
+    atomic<bool> stop(false);
+    atomic<long long> queries(0), sink(0);
+    vector<thread> threads;
+    threads.emplace_back([&] {
+        mt19937 w(9);
+        while (!stop) {
+            uf.unionSets(w() % n, w() % n);
+            this_thread::sleep_for(chrono::microseconds(50));
+        }
+    });
+    for (int t = 0; t < readers; t++) {
+        threads.emplace_back([&, t] {
+            mt19937 r(100 + t);
+            long long local = 0, hits = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                for (int k = 0; k < 1024; k++) hits += uf.connected(r() % n, r() % n);
+                local += 1024;
+            }
+            queries += local;
+            sink += hits;
+        });
+    }
+    auto start = chrono::steady_clock::now();
+    this_thread::sleep_for(chrono::milliseconds(1500));
+    stop = true;
+    for (auto& th : threads) th.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    uf.stopCompactor();
+    return {queries.load(), seconds, uf.averageDepth(), uf.compactorPasses()};
+}
+
+int main() {
+    const int n = 1 << 21;
+    int readers = max(2u, thread::hardware_concurrency());
+
+    // sanity: concurrent unions from several threads match a sequential run
+    {
+        const int m = 1 << 20, writers = 4;
+        vector<pair<int, int>> edges(m);
+        mt19937 rng(3);
+        for (auto& e : edges) e = {(int)(rng() % n), (int)(rng() % n)};
+        ConcurrentUnionFind uf(n);
+        uf.startCompactor();
+        vector<thread> pool;
+        for (int t = 0; t < writers; t++) {
+            pool.emplace_back([&, t] {
+                for (int i = t; i < m; i += writers) uf.unionSets(edges[i].first, edges[i].second);
+            });
+        }
+        for (auto& th : pool) th.join();
+        uf.stopCompactor();
+        ConcurrentUnionFind seq(n);
+        for (auto& e : edges) seq.unionSets(e.first, e.second);
+        long long mismatches = 0;
+        for (int i = 0; i < 200000; i++) {
+            int a = rng() % n, b = edges[rng() % m].first;
+            if (uf.connected(a, b) != seq.connected(a, b)) mismatches++;
+        }
+        cout << "Concurrent vs sequential unions: mismatches " << mismatches << endl;
+    }
+
+    cout << "Read-mostly load, " << readers << " reader threads + 1 writer:" << endl;
+    struct Mode {
+        const char* name;
+        bool compressOnRead, compactor;
+    };
+    for (Mode m : {Mode{"no compression", false, false}, Mode{"path halving in find", true, false},
+                   Mode{"read-only + compactor", false, true}}) {
+        RunStats s = readMostly(m.compressOnRead, m.compactor, n, readers, n / 2);
+        cout << "  " << left << setw(22) << m.name << right << ": " << (long long)(s.queries / s.seconds) << " queries/s, average depth "
+             << fixed << setprecision(2) << s.depth << ", compactor passes " << s.passes << endl;
+    }
+    return 0;
+}
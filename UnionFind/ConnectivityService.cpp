@@ -0,0 +1,451 @@
+#include <bits/stdc++.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "UnionFind.cpp"
+using namespace std;
+
+// Local connectivity service: a union-find by relabelling behind a UNIX
+// domain socket.
+//
+// Wire format (native byte order, the socket never leaves the host):
+//   request frame  = u32 count, then count records of { u8 op, u32 a, u32 b }
+//   response frame = u32 count, then count u32 results
+//
+// Clients may pipeline any number of frames without waiting for replies.
+// A frame is the unit of work: the writer path applies every UNION in it, then
+// the reader path answers FIND / CONNECTED. There is no forest to walk: every
+// element stores its set's label (one of its members), so a query is one or
+// two array reads and never writes, unlike a find with path compression.
+//
+// A union relabels the smaller set. Each set's members form a circular list
+// threaded through nextMember, so relabelling walks exactly the moved members
+// and the two lists are spliced in O(1). An element moves O(log n) times, so
+// unions cost O(n log n) over the service's lifetime. State is three u32 per
+// element: label, nextMember, and setSize (meaningful at labels only). FIND
+// answers with the label, a stable member of the set.
+//
+// Backpressure: once a connection has OUT_BUFFER_CAP unsent reply bytes, the
+// service stops reading from it and stops processing its buffered frames
+// until the client reads replies. A client that never reads stalls only
+// itself, and its buffers stay bounded.
+
+enum Op : uint8_t { OP_UNION = 0, OP_FIND = 1, OP_CONNECTED = 2 };
+
+const uint32_t BAD_REQUEST = 0xFFFFFFFFu;
+const size_t RECORD_BYTES = 9;
+const uint32_t MAX_FRAME_RECORDS = 1u << 20;
+const size_t IN_BUFFER_CAP = 4 + MAX_FRAME_RECORDS * RECORD_BYTES;  // always room for one whole frame
+const size_t OUT_BUFFER_CAP = 1 << 22;
+
+class ConnectivityService {
+   private:
+    int n;
+    vector<uint32_t> label;       // label[i] = label of i's set
+    vector<uint32_t> nextMember;  // next element of i's set, circularly
+    vector<uint32_t> setSize;     // setSize[l] = size of the set labelled l
+
+    struct Connection {
+        vector<uint8_t> in, out;
+        size_t outPos = 0;
+    };
+
+    int listenFd = -1, epollFd = -1;
+    unordered_map<int, Connection> conns;
+    vector<uint32_t> results;
+
+    static void setNonBlocking(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    bool valid(uint32_t x) const { return x < (uint32_t)n; }
+
+    // writer path: only unions change labels
+    uint32_t applyUnion(uint32_t a, uint32_t b) {
+        if (!valid(a) || !valid(b)) return BAD_REQUEST;
+        uint32_t keep = label[a], gone = label[b];
+        if (keep == gone) return 0;
+        if (setSize[keep] < setSize[gone]) swap(keep, gone);
+        uint32_t x = gone;
+        do {
+            label[x] = keep;
+            x = nextMember[x];
+        } while (x != gone);
+        swap(nextMember[keep], nextMember[gone]);  // splice the two circles
+        setSize[keep] += setSize[gone];
+        return 1;
+    }
+
+    // reader path: read-only lookups
+    uint32_t answer(uint8_t op, uint32_t a, uint32_t b) const {
+        if (op == OP_FIND) return valid(a) ? label[a] : BAD_REQUEST;
+        if (op == OP_CONNECTED) {
+            if (!valid(a) || !valid(b)) return BAD_REQUEST;
+            return label[a] == label[b];
+        }
+        return BAD_REQUEST;
+    }
+
+    void processFrame(const uint8_t* rec, uint32_t count, vector<uint8_t>& out) {
+        results.assign(count, 0);
+        for (uint32_t i = 0; i < count; i++) {
+            const uint8_t* r = rec + i * RECORD_BYTES;
+            if (r[0] != OP_UNION) continue;
+            uint32_t a, b;
+            memcpy(&a, r + 1, 4);
+            memcpy(&b, r + 5, 4);
+            results[i] = applyUnion(a, b);
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            const uint8_t* r = rec + i * RECORD_BYTES;
+            if (r[0] == OP_UNION) continue;
+            uint32_t a, b;
+            memcpy(&a, r + 1, 4);
+            memcpy(&b, r + 5, 4);
+            results[i] = answer(r[0], a, b);
+        }
+        size_t at = out.size();
+        out.resize(at + 4 + 4 * (size_t)count);
+        memcpy(&out[at], &count, 4);
+        if (count > 0) memcpy(&out[at + 4], results.data(), 4 * (size_t)count);
+    }
+
+    static bool backlogged(const Connection& c) { return c.out.size() - c.outPos >= OUT_BUFFER_CAP; }
+
+    // consume complete frames from the input buffer until it runs out or the
+    // replies back up; false = protocol error
+    bool drainFrames(Connection& c) {
+        size_t pos = 0;
+        while (c.in.size() - pos >= 4 && !backlogged(c)) {
+            uint32_t count;
+            memcpy(&count, &c.in[pos], 4);
+            if (count > MAX_FRAME_RECORDS) return false;
+            size_t need = 4 + (size_t)count * RECORD_BYTES;
+            if (c.in.size() - pos < need) break;
+            processFrame(c.in.data() + pos + 4, count, c.out);
+            pos += need;
+        }
+        c.in.erase(c.in.begin(), c.in.begin() + pos);
+        return true;
+    }
+
+    void closeConnection(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conns.erase(fd);
+    }
+
+    // write what the socket takes; false when the peer must be dropped
+    bool flush(int fd, Connection& c) {
+        while (c.outPos < c.out.size()) {
+            ssize_t w = write(fd, c.out.data() + c.outPos, c.out.size() - c.outPos);
+            if (w < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            c.outPos += w;
+        }
+        if (c.outPos == c.out.size()) {
+            c.out.clear();
+            c.outPos = 0;
+        } else if (c.outPos > c.out.size() / 2) {
+            c.out.erase(c.out.begin(), c.out.begin() + c.outPos);
+            c.outPos = 0;
+        }
+        return true;
+    }
+
+    // answer buffered frames and send replies while the peer keeps up, then
+    // listen for input only if there is room for it; false = drop the peer
+    bool pump(int fd, Connection& c) {
+        while (true) {
+            size_t before = c.in.size();
+            if (!drainFrames(c) || !flush(fd, c)) return false;
+            if (c.in.size() == before || backlogged(c)) break;
+        }
+        epoll_event ev{};
+        if (!backlogged(c) && c.in.size() < IN_BUFFER_CAP) ev.events |= EPOLLIN;
+        if (c.out.size() > c.outPos) ev.events |= EPOLLOUT;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        return true;
+    }
+
+    void acceptAll() {
+        while (true) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) return;
+            setNonBlocking(fd);
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+            conns[fd];
+        }
+    }
+
+    void onReadable(int fd) {
+        Connection& c = conns[fd];
+        uint8_t buf[1 << 16];
+        while (c.in.size() < IN_BUFFER_CAP) {
+            ssize_t r = read(fd, buf, min(sizeof(buf), IN_BUFFER_CAP - c.in.size()));
+            if (r > 0) {
+                c.in.insert(c.in.end(), buf, buf + r);
+                continue;
+            }
+            if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                closeConnection(fd);
+                return;
+            }
+            break;
+        }
+        if (!pump(fd, c)) closeConnection(fd);
+    }
+
+   public:
+    ConnectivityService(int n) : n(n), label(n), nextMember(n), setSize(n, 1) {
+        iota(label.begin(), label.end(), 0);
+        iota(nextMember.begin(), nextMember.end(), 0);
+    }
+
+    bool listenOn(const string& path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        strcpy(addr.sun_path, path.c_str());
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        unlink(path.c_str());
+        if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 128) < 0 ||
+            (epollFd = epoll_create1(0)) < 0) {
+            int saved = errno;  // for the caller's perror
+            close(listenFd);
+            listenFd = -1;
+            errno = saved;
+            return false;
+        }
+        setNonBlocking(listenFd);
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+        return true;
+    }
+
+    // event loop; polls `stop` between waits so a local test can end it
+    void run(const atomic<bool>& stop) {
+        epoll_event events[64];
+        while (!stop.load()) {
+            int k = epoll_wait(epollFd, events, 64, 100);
+            for (int i = 0; i < k; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll();
+                } else if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    closeConnection(fd);
+                } else {
+                    if (events[i].events & EPOLLIN) onReadable(fd);
+                    auto it = conns.find(fd);
+                    if (it != conns.end() && (events[i].events & EPOLLOUT) && !pump(fd, it->second)) {
+                        closeConnection(fd);
+                    }
+                }
+            }
+        }
+        for (auto& kv : conns) close(kv.first);
+        conns.clear();
+        close(epollFd);
+        close(listenFd);
+    }
+};
+
+// Minimal blocking client used by the local demo.
+class ConnectivityClient {
+   private:
+    int fd = -1;
+    vector<uint8_t> frame;
+    uint32_t pending = 0;
+
+    bool readExact(void* dst, size_t len) {
+        uint8_t* p = (uint8_t*)dst;
+        while (len > 0) {
+            ssize_t r = read(fd, p, len);
+            if (r <= 0) return false;
+            p += r;
+            len -= r;
+        }
+        return true;
+    }
+
+   public:
+    bool connectTo(const string& path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        strcpy(addr.sun_path, path.c_str());
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        for (int attempt = 0; attempt < 50; attempt++) {
+            if (connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) return true;
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    void add(uint8_t op, uint32_t a, uint32_t b = 0) {
+        if (frame.empty()) frame.resize(4);
+        uint8_t rec[RECORD_BYTES];
+        rec[0] = op;
+        memcpy(rec + 1, &a, 4);
+        memcpy(rec + 5, &b, 4);
+        frame.insert(frame.end(), rec, rec + RECORD_BYTES);
+        pending++;
+    }
+
+    // send the current batch without waiting for its reply
+    bool send() {
+        memcpy(frame.data(), &pending, 4);
+        size_t off = 0;
+        while (off < frame.size()) {
+            ssize_t w = write(fd, frame.data() + off, frame.size() - off);
+            if (w <= 0) return false;
+            off += w;
+        }
+        frame.clear();
+        pending = 0;
+        return true;
+    }
+
+    bool receive(vector<uint32_t>& results) {
+        uint32_t count;
+        if (!readExact(&count, 4)) return false;
+        results.resize(count);
+        return count == 0 || readExact(results.data(), 4 * (size_t)count);
+    }
+
+    ~ConnectivityClient() {
+        if (fd >= 0) close(fd);
+    }
+};
+
+int main(int argc, char** argv) {
+    // ./ConnectivityService serve <socket-path> <n>   runs the service forever
+    if (argc == 4 && string(argv[1]) == "serve") {
+        ConnectivityService service(atoi(argv[3]));
+        if (!service.listenOn(argv[2])) {
+            perror("listen");
+            return 1;
+        }
+        atomic<bool> stop(false);
+        service.run(stop);
+        return 0;
+    }
+
+    // otherwise: self-contained local test, server and client in one process
+    const int n = 100000;
+    string path = "/tmp/uf_service_" + to_string(getpid()) + ".sock";
+    ConnectivityService service(n);
+    if (!service.listenOn(path)) {
+        perror("listen");
+        return 1;
+    }
+    atomic<bool> stop(false);
+    thread server([&] { service.run(stop); });
+
+    ConnectivityClient client;
+    if (!client.connectTo(path)) {
+        cout << "Could not connect to " << path << endl;
+        stop = true;
+        server.join();
+        return 1;
+    }
+
+    vector<uint32_t> res;
+    client.add(OP_UNION, 1, 2);
+    client.add(OP_UNION, 2, 3);
+    client.add(OP_UNION, 1, 3);
+    client.add(OP_CONNECTED, 1, 3);
+    client.add(OP_CONNECTED, 1, 4);
+    client.add(OP_FIND, n + 5);
+    client.send();
+    client.receive(res);
+    cout << "union(1,2)=" << res[0] << " union(2,3)=" << res[1] << " union(1,3)=" << res[2]
+         << " connected(1,3)=" << res[3] << " connected(1,4)=" << res[4]
+         << " find(out of range)=" << (res[5] == BAD_REQUEST ? "BAD_REQUEST" : "?") << endl;
+
+    // pipelined throughput: many frames in flight, verified against a local copy
+    const int frames = 200, perFrame = 5000, window = 16;
+    mt19937 rng(42);
+    UnionFind reference(n);
+    reference.unionSets(1, 2);
+    reference.unionSets(2, 3);
+    vector<vector<pair<uint32_t, uint32_t>>> queries(frames);
+    vector<vector<uint32_t>> expected(frames);
+    long long mismatches = 0;
+    int received = 0;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < perFrame; i++) {
+            uint32_t a = rng() % n, b = rng() % n;
+            if (i % 4 == 0) {
+                client.add(OP_UNION, a, b);
+                reference.unionSets(a, b);
+            } else {
+                client.add(OP_CONNECTED, a, b);
+                queries[f].push_back({a, b});
+            }
+        }
+        for (auto& q : queries[f]) expected[f].push_back(reference.connected(q.first, q.second));
+        client.send();
+        if (f - received >= window) {
+            client.receive(res);
+            size_t k = 0;
+            for (int i = 0; i < perFrame; i++) {
+                if (i % 4 != 0 && res[i] != expected[received][k++]) mismatches++;
+            }
+            received++;
+        }
+    }
+    while (received < frames) {
+        client.receive(res);
+        size_t k = 0;
+        for (int i = 0; i < perFrame; i++) {
+            if (i % 4 != 0 && res[i] != expected[received][k++]) mismatches++;
+        }
+        received++;
+    }
+    auto end = chrono::high_resolution_clock::now();
+    auto us = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+    cout << "Pipelined " << (long long)frames * perFrame << " requests in " << us
+         << " microseconds (" << (long long)frames * perFrame * 1000000LL / max<long long>(us, 1)
+         << " req/s), mismatches: " << mismatches << endl;
+
+    // backpressure: a client that pipelines 40 MB of replies and never reads
+    // them stalls only itself; the service keeps answering everyone else
+    signal(SIGPIPE, SIG_IGN);  // the stalled client's writes fail once the service stops
+    ConnectivityClient greedy;
+    greedy.connectTo(path);
+    thread flood([&] {
+        for (int f = 0; f < 200; f++) {
+            for (int i = 0; i < 50000; i++) greedy.add(OP_CONNECTED, i, i + 1);
+            if (!greedy.send()) return;  // blocks once the service stops reading from it
+        }
+    });
+    this_thread::sleep_for(chrono::milliseconds(500));
+    client.add(OP_CONNECTED, 1, 3);
+    client.send();
+    bool answered = client.receive(res) && res.size() == 1 && res[0] == 1;
+    cout << "With a client that never reads its replies, another client is " << (answered ? "still served" : "STUCK")
+         << endl;
+
+    stop = true;
+    server.join();
+    flood.join();
+    unlink(path.c_str());
+    return 0;
+}
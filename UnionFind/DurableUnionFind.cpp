@@ -0,0 +1,315 @@
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "UnionFind.cpp"
+using namespace std;
+
+// Crash-safe UnionFind: write-ahead log + group commit + checkpoints.
+//
+// Files in the data directory:
+//   wal         - append-only union records { u32 u, u32 v, u32 check }
+//   checkpoint  - { magic, n, labels[n], check }, where labels[i] = find(i)
+//
+// unionSets() applies the union in memory and appends its record to a buffer.
+// The buffer is written and fdatasync'ed as one group once it holds
+// `groupSize` records or `maxDelay` has passed since the last sync (checked on
+// each call), or when commit() is called. Only committed unions are durable.
+//
+// checkpoint() writes the flattened labels to a temp file, fsyncs it, renames
+// it over the old checkpoint, then truncates the WAL. Recovery loads the
+// checkpoint (throwing if it exists but is damaged, since the WAL no longer
+// holds what it covered) and replays the WAL up to the first torn or corrupt
+// record. Unions are idempotent, so a crash between the rename and the
+// truncate only replays records the checkpoint already contains.
+
+struct DurabilityOptions {
+    size_t groupSize = 256;                   // records per fsync
+    chrono::microseconds maxDelay{5000};      // or sync once the oldest buffered record is this old
+    size_t checkpointEvery = 1 << 22;         // records between automatic checkpoints (0 = never)
+};
+
+class DurableUnionFind {
+   private:
+    static const uint32_t MAGIC = 0x55464350;  // "UFCP"
+
+    string dir;
+    int n;
+    DurabilityOptions opt;
+    UnionFind uf;
+    int walFd = -1;
+    vector<uint32_t> buffer;
+    chrono::steady_clock::time_point oldest;
+    size_t sinceCheckpoint = 0;
+    long long syncs = 0;
+    bool fromCheckpoint = false;
+    long long replayedRecords = 0;
+
+    static uint32_t check(uint32_t a, uint32_t b) {
+        uint64_t h = ((uint64_t)a << 32 | b) * 0x9E3779B97F4A7C15ULL;
+        return (uint32_t)(h >> 32) ^ 0xA5A5A5A5u;
+    }
+
+    string path(const string& name) const { return dir + "/" + name; }
+
+    static bool writeAll(int fd, const void* data, size_t len) {
+        const char* p = (const char*)data;
+        while (len > 0) {
+            ssize_t w = write(fd, p, len);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += w;
+            len -= w;
+        }
+        return true;
+    }
+
+    void fsyncDir() {
+        int fd = open(dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+    }
+
+    // false only if there is no checkpoint. The WAL was truncated when the
+    // checkpoint was written, so a damaged checkpoint cannot be recovered
+    // from: it throws rather than silently dropping the unions it held.
+    bool loadCheckpoint() {
+        string file = path("checkpoint");
+        int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0) {
+            if (errno == ENOENT) return false;
+            throw runtime_error("cannot open " + file);
+        }
+        vector<uint32_t> data(n + 3);
+        size_t want = data.size() * 4, got = 0;
+        char* p = (char*)data.data();
+        ssize_t r;
+        while (got < want && (r = read(fd, p + got, want - got)) != 0) {
+            if (r < 0 && errno == EINTR) continue;
+            if (r < 0) break;
+            got += r;
+        }
+        char extra;
+        bool exactLength = got == want && read(fd, &extra, 1) == 0;
+        close(fd);
+        if (got < 8 || data[0] != MAGIC) throw runtime_error(file + ": bad magic");
+        if (data[1] != (uint32_t)n) throw runtime_error(file + ": written for n = " + to_string(data[1]));
+        if (!exactLength) throw runtime_error(file + ": wrong length");
+        uint32_t h = 0;
+        for (int i = 0; i < n; i++) {
+            if (data[i + 2] >= (uint32_t)n) throw runtime_error(file + ": label out of range");
+            h = check(h, data[i + 2]);
+        }
+        if (h != data[n + 2]) throw runtime_error(file + ": checksum mismatch");
+        for (int i = 0; i < n; i++) uf.unionSets(i, data[i + 2]);
+        return true;
+    }
+
+    // replay intact records; returns the byte length of the valid prefix
+    off_t replayWal(long long& replayed) {
+        int fd = open(path("wal").c_str(), O_RDONLY);
+        if (fd < 0) return 0;
+        off_t valid = 0;
+        vector<uint32_t> chunk(3 * 4096);
+        while (true) {
+            ssize_t r = read(fd, chunk.data(), chunk.size() * 4);
+            if (r <= 0) break;
+            size_t records = r / 12;
+            bool stop = false;
+            for (size_t i = 0; i < records; i++) {
+                uint32_t u = chunk[3 * i], v = chunk[3 * i + 1];
+                if (chunk[3 * i + 2] != check(u, v) || u >= (uint32_t)n || v >= (uint32_t)n) {
+                    stop = true;
+                    break;
+                }
+                uf.unionSets(u, v);
+                valid += 12;
+                replayed++;
+            }
+            if (stop || r % 12 != 0) break;
+        }
+        close(fd);
+        return valid;
+    }
+
+   public:
+    // opens (and recovers) the structure stored in `dir`
+    DurableUnionFind(const string& dir, int n, DurabilityOptions opt = DurabilityOptions())
+        : dir(dir), n(n), opt(opt), uf(n) {
+        mkdir(dir.c_str(), 0755);
+        fromCheckpoint = loadCheckpoint();
+        off_t valid = replayWal(replayedRecords);
+        walFd = open(path("wal").c_str(), O_WRONLY | O_CREAT, 0644);
+        if (walFd < 0) throw runtime_error("cannot open " + path("wal"));
+        // cut off a torn tail so new records follow the last good one
+        if (ftruncate(walFd, valid) != 0 || lseek(walFd, valid, SEEK_SET) < 0) {
+            close(walFd);
+            throw runtime_error("cannot truncate " + path("wal"));
+        }
+        sinceCheckpoint = replayedRecords;
+    }
+
+    // commits what is buffered; a destructor must not throw, so a failed
+    // commit is reported on stderr. Call commit() first to handle it.
+    ~DurableUnionFind() {
+        if (walFd < 0) return;
+        try {
+            commit();
+        } catch (const exception& e) {
+            cerr << "DurableUnionFind: " << e.what() << " on close; " << buffer.size() / 3
+                 << " unions not durable" << endl;
+        }
+        close(walFd);
+    }
+
+    void unionSets(int u, int v) {
+        uf.unionSets(u, v);
+        if (buffer.empty()) oldest = chrono::steady_clock::now();
+        buffer.push_back(u);
+        buffer.push_back(v);
+        buffer.push_back(check(u, v));
+        sinceCheckpoint++;
+        if (buffer.size() / 3 >= opt.groupSize || chrono::steady_clock::now() - oldest >= opt.maxDelay) commit();
+        if (opt.checkpointEvery && sinceCheckpoint >= opt.checkpointEvery) checkpoint();
+    }
+
+    int find(int u) { return uf.find(u); }
+    bool connected(int u, int v) { return uf.connected(u, v); }
+
+    // make every union so far durable
+    void commit() {
+        if (buffer.empty()) return;
+        if (!writeAll(walFd, buffer.data(), buffer.size() * 4) || fdatasync(walFd) != 0) {
+            throw runtime_error("WAL write failed");
+        }
+        buffer.clear();
+        syncs++;
+    }
+
+    void checkpoint() {
+        commit();
+        vector<uint32_t> data(n + 3);
+        data[0] = MAGIC;
+        data[1] = n;
+        uint32_t h = 0;
+        for (int i = 0; i < n; i++) {
+            data[i + 2] = uf.find(i);
+            h = check(h, data[i + 2]);
+        }
+        data[n + 2] = h;
+        string tmp = path("checkpoint.tmp");
+        int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw runtime_error("cannot create " + tmp);
+        bool written = writeAll(fd, data.data(), data.size() * 4) && fsync(fd) == 0;
+        close(fd);
+        if (!written) throw runtime_error("checkpoint write failed");
+        if (rename(tmp.c_str(), path("checkpoint").c_str()) != 0) throw runtime_error("checkpoint rename failed");
+        fsyncDir();
+        if (ftruncate(walFd, 0) != 0 || lseek(walFd, 0, SEEK_SET) < 0 || fsync(walFd) != 0) {
+            throw runtime_error("WAL truncate failed");
+        }
+        sinceCheckpoint = 0;
+    }
+
+    // simulate a crash: drop the uncommitted buffer and the file handle
+    void crash() {
+        buffer.clear();
+        close(walFd);
+        walFd = -1;
+    }
+
+    long long syncCount() const { return syncs; }
+    bool recoveredFromCheckpoint() const { return fromCheckpoint; }
+    long long recoveredRecords() const { return replayedRecords; }
+};
+
+void removeDir(const string& dir) {
+    for (const char* f : {"wal", "checkpoint", "checkpoint.tmp"}) unlink((dir + "/" + f).c_str());
+    rmdir(dir.c_str());
+}
+
+int main() {
+    const int n = 1 << 20;
+    char tmpl[] = "/tmp/durable_uf_XXXXXX";
+    string base = mkdtemp(tmpl);
+
+    // recovery: checkpoint + WAL replay, uncommitted tail lost, torn record ignored
+    {
+        string dir = base + "/recovery";
+        mt19937 rng(1);
+        UnionFind committed(n);
+        {
+            DurableUnionFind d(dir, n);
+            for (int i = 0; i < 200000; i++) {
+                int u = rng() % n, v = rng() % n;
+                d.unionSets(u, v);
+                committed.unionSets(u, v);
+                if (i == 100000) d.checkpoint();
+            }
+            d.commit();
+            for (int i = 0; i < 50; i++) d.unionSets(rng() % n, rng() % n);  // never committed
+            d.crash();
+        }
+        {
+            int fd = open((dir + "/wal").c_str(), O_WRONLY | O_APPEND);
+            uint32_t torn[2] = {7, 8};  // half a record, as if power failed mid-write
+            if (write(fd, torn, sizeof(torn)) != sizeof(torn)) cout << "could not append torn record" << endl;
+            close(fd);
+        }
+        DurableUnionFind r(dir, n);
+        long long mismatches = 0;
+        for (int i = 0; i < n; i += 97) {
+            int j = (i * 7919LL) % n;
+            if (r.connected(i, j) != committed.connected(i, j)) mismatches++;
+        }
+        cout << "Recovered from checkpoint: " << (r.recoveredFromCheckpoint() ? "yes" : "no") << ", replayed "
+             << r.recoveredRecords() << " WAL records, mismatches vs committed state: " << mismatches << endl;
+    }
+
+    // throughput at several group-commit sizes
+    cout << "Unions per second by fsync group size:" << endl;
+    for (size_t group : {1, 16, 256, 4096, 65536}) {
+        string dir = base + "/bench" + to_string(group);
+        DurabilityOptions opt;
+        opt.groupSize = group;
+        opt.maxDelay = chrono::microseconds(1000000);
+        opt.checkpointEvery = 0;
+        mt19937 rng(2);
+        DurableUnionFind d(dir, n, opt);
+        long long ops = 0;
+        auto start = chrono::high_resolution_clock::now();
+        auto deadline = start + chrono::milliseconds(1000);
+        while (chrono::high_resolution_clock::now() < deadline) {
+            for (int i = 0; i < 256; i++) d.unionSets(rng() % n, rng() % n);
+            ops += 256;
+        }
+        d.commit();
+        auto us = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count();
+        cout << "  group " << setw(5) << group << ": " << setw(10) << ops * 1000000 / us << " unions/s ("
+             << d.syncCount() << " fsyncs)" << endl;
+    }
+
+    // in-memory baseline
+    {
+        mt19937 rng(2);
+        UnionFind uf(n);
+        long long ops = 0;
+        auto start = chrono::high_resolution_clock::now();
+        auto deadline = start + chrono::milliseconds(1000);
+        while (chrono::high_resolution_clock::now() < deadline) {
+            for (int i = 0; i < 256; i++) uf.unionSets(rng() % n, rng() % n);
+            ops += 256;
+        }
+        auto us = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count();
+        cout << "  no WAL:      " << setw(10) << ops * 1000000 / us << " unions/s" << endl;
+    }
+
+    removeDir(base + "/recovery");
+    for (size_t group : {1, 16, 256, 4096, 65536}) removeDir(base + "/bench" + to_string(group));
+    rmdir(base.c_str());
+    return 0;
+}
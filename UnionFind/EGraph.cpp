@@ -0,0 +1,439 @@
+#include <bits/stdc++.h>
+#include "UnionFind.cpp"
+using namespace std;
+
+// E-graph (congruence closure) on top of UnionFind, with egg-style rebuilding.
+//
+// - E-classes are UnionFind sets; per-root data holds the class's e-nodes and
+//   the parent e-nodes that point into it.
+// - E-nodes live in one flat table (op, first child, arity) with children in a
+//   shared pool. The hash-cons is a hash set of node ids whose hash and
+//   equality read the table, so the structure never stores a second copy of a
+//   node.
+// - merge() only unions and records the class on a worklist. rebuild()
+//   restores the invariants in one batch: it re-canonicalizes the parents of
+//   dirty classes, and parents that collide in the hash-cons are congruent, so
+//   their classes merge too. Deferring this repair is what makes bulk merging
+//   cheap.
+// - Equality saturation: patterns like "(* ?x 1)" are e-matched against every
+//   class, all matches of all rules are collected first, then instantiated and
+//   merged, then the graph is rebuilt once per iteration.
+
+class EGraph {
+   private:
+    struct ENode {
+        int op, first, arity;
+    };
+
+    vector<ENode> nodes;
+    vector<int> kids;
+    vector<int> nodeClass;  // class the node was added to (find() it before use)
+    vector<string> ops;
+    unordered_map<string, int> opIds;
+
+    UnionFind uf;
+    vector<vector<int>> classNodes, classParents;  // indexed by class root
+    vector<int> worklist;
+    int unions = 0;
+
+    struct NodeHash {
+        const EGraph* g;
+        size_t operator()(int id) const {
+            const ENode& n = g->nodes[id];
+            size_t h = n.op * 0x9E3779B97F4A7C15ULL;
+            for (int i = 0; i < n.arity; i++) h = (h ^ g->kids[n.first + i]) * 0x100000001B3ULL;
+            return h;
+        }
+    };
+    struct NodeEq {
+        const EGraph* g;
+        bool operator()(int a, int b) const {
+            const ENode &x = g->nodes[a], &y = g->nodes[b];
+            if (x.op != y.op || x.arity != y.arity) return false;
+            for (int i = 0; i < x.arity; i++) {
+                if (g->kids[x.first + i] != g->kids[y.first + i]) return false;
+            }
+            return true;
+        }
+    };
+    unordered_map<int, int, NodeHash, NodeEq> memo;  // node id -> class
+
+    void canonicalize(int id) {
+        ENode& n = nodes[id];
+        for (int i = 0; i < n.arity; i++) kids[n.first + i] = uf.find(kids[n.first + i]);
+    }
+
+    // drop `id` from the hash-cons only if it is the entry stored there
+    void unmemo(int id) {
+        auto it = memo.find(id);
+        if (it != memo.end() && it->first == id) memo.erase(it);
+    }
+
+    void repair(int c) {
+        vector<int> parents;
+        parents.swap(classParents[c]);
+        for (int p : parents) {
+            unmemo(p);
+            canonicalize(p);
+            int pc = uf.find(nodeClass[p]);
+            auto it = memo.find(p);
+            if (it == memo.end()) {
+                memo.emplace(p, pc);
+            } else {
+                merge(it->second, pc);  // congruent to an existing node
+            }
+        }
+        // keep one parent per distinct canonical node
+        unordered_set<int, NodeHash, NodeEq> seen(parents.size() * 2 + 1, NodeHash{this}, NodeEq{this});
+        vector<int>& keep = classParents[uf.find(c)];
+        for (int p : parents) {
+            if (seen.insert(p).second) keep.push_back(p);
+        }
+    }
+
+   public:
+    EGraph() : uf(0), memo(16, NodeHash{this}, NodeEq{this}) {}
+    EGraph(const EGraph&) = delete;
+    EGraph& operator=(const EGraph&) = delete;
+
+    int op(const string& name) {
+        auto it = opIds.find(name);
+        if (it != opIds.end()) return it->second;
+        ops.push_back(name);
+        return opIds[name] = ops.size() - 1;
+    }
+    const string& opName(int id) const { return ops[id]; }
+
+    int find(int c) { return uf.find(c); }
+
+    // add an e-node; returns its (existing or new) e-class
+    int add(int opId, const vector<int>& children) {
+        int id = nodes.size();
+        nodes.push_back({opId, (int)kids.size(), (int)children.size()});
+        for (int c : children) kids.push_back(uf.find(c));
+        auto it = memo.find(id);
+        if (it != memo.end()) {
+            nodes.pop_back();
+            kids.resize(kids.size() - children.size());
+            return uf.find(it->second);
+        }
+        int c = uf.makeSet();
+        classNodes.push_back({id});
+        classParents.emplace_back();
+        nodeClass.push_back(c);
+        memo.emplace(id, c);
+        for (int i = 0; i < nodes[id].arity; i++) classParents[kids[nodes[id].first + i]].push_back(id);
+        return c;
+    }
+
+    int add(const string& name, const vector<int>& children = {}) { return add(op(name), children); }
+
+    // union two classes; invariants are restored by the next rebuild()
+    int merge(int a, int b) {
+        int ra = uf.find(a), rb = uf.find(b);
+        if (ra == rb) return ra;
+        uf.unionSets(ra, rb);
+        unions++;
+        int r = uf.find(ra), o = r == ra ? rb : ra;
+        // append the shorter lists onto the longer ones
+        if (classNodes[r].size() < classNodes[o].size()) classNodes[r].swap(classNodes[o]);
+        if (classParents[r].size() < classParents[o].size()) classParents[r].swap(classParents[o]);
+        classNodes[r].insert(classNodes[r].end(), classNodes[o].begin(), classNodes[o].end());
+        classParents[r].insert(classParents[r].end(), classParents[o].begin(), classParents[o].end());
+        vector<int>().swap(classNodes[o]);
+        vector<int>().swap(classParents[o]);
+        worklist.push_back(r);
+        return r;
+    }
+
+    void rebuild() {
+        vector<int> touched;
+        while (!worklist.empty()) {
+            vector<int> todo;
+            todo.swap(worklist);
+            for (int& c : todo) c = uf.find(c);
+            sort(todo.begin(), todo.end());
+            todo.erase(unique(todo.begin(), todo.end()), todo.end());
+            for (int c : todo) repair(c);
+            touched.insert(touched.end(), todo.begin(), todo.end());
+        }
+        // canonicalize and dedupe the node lists of the classes that changed
+        for (int& c : touched) c = uf.find(c);
+        sort(touched.begin(), touched.end());
+        touched.erase(unique(touched.begin(), touched.end()), touched.end());
+        for (int c : touched) {
+            unordered_set<int, NodeHash, NodeEq> seen(classNodes[c].size() * 2 + 1, NodeHash{this}, NodeEq{this});
+            vector<int> keep;
+            for (int id : classNodes[c]) {
+                canonicalize(id);
+                if (seen.insert(id).second) keep.push_back(id);
+            }
+            classNodes[c].swap(keep);
+        }
+    }
+
+    // the canonical id of every class
+    vector<int> classes() {
+        vector<int> ids;
+        for (int c = 0; c < (int)classNodes.size(); c++) {
+            if (uf.find(c) == c) ids.push_back(c);
+        }
+        return ids;
+    }
+
+    int numClasses() { return classes().size(); }
+    int numNodes() const { return nodes.size(); }
+    int numUnions() const { return unions; }
+
+    // --- patterns and e-matching -------------------------------------------
+
+    struct Pattern {
+        int var = -1;  // >= 0 for ?variables
+        int opId = -1;
+        vector<Pattern> children;
+    };
+    typedef vector<pair<int, int>> Subst;  // (variable, class)
+
+    // parse "(op child child)" / "leaf" / "?var"; variables are numbered via
+    // `vars`. Throws invalid_argument on malformed input.
+    Pattern parse(const string& s, map<string, int>& vars) {
+        size_t pos = 0;
+        Pattern p = parseAt(s, pos, vars);
+        skipSpaces(s, pos);
+        if (pos != s.size()) throw invalid_argument("unexpected '" + s.substr(pos, 1) + "' in pattern: " + s);
+        return p;
+    }
+
+   private:
+    static void skipSpaces(const string& s, size_t& pos) {
+        while (pos < s.size() && s[pos] == ' ') pos++;
+    }
+
+    // the operator or leaf name at pos, which must not be empty
+    static string token(const string& s, size_t& pos) {
+        size_t end = min(s.find_first_of(" ()", pos), s.size());
+        if (end == pos) {
+            throw invalid_argument(pos == s.size() ? "unexpected end of pattern: " + s
+                                                   : "unexpected '" + s.substr(pos, 1) + "' in pattern: " + s);
+        }
+        string tok = s.substr(pos, end - pos);
+        pos = end;
+        return tok;
+    }
+
+    Pattern parseAt(const string& s, size_t& pos, map<string, int>& vars) {
+        skipSpaces(s, pos);
+        Pattern p;
+        if (pos < s.size() && s[pos] == '(') {
+            pos++;
+            p.opId = op(token(s, pos));
+            while (true) {
+                skipSpaces(s, pos);
+                if (pos == s.size()) throw invalid_argument("unbalanced '(' in pattern: " + s);
+                if (s[pos] == ')') {
+                    pos++;
+                    break;
+                }
+                p.children.push_back(parseAt(s, pos, vars));
+            }
+            return p;
+        }
+        string tok = token(s, pos);
+        if (tok[0] == '?') {
+            auto it = vars.find(tok);
+            p.var = it != vars.end() ? it->second : (vars[tok] = vars.size());
+        } else {
+            p.opId = op(tok);
+        }
+        return p;
+    }
+
+    void matchIn(const Pattern& p, int c, Subst& s, const function<void(Subst&)>& k) {
+        c = uf.find(c);
+        if (p.var >= 0) {
+            for (auto& b : s) {
+                if (b.first == p.var) {
+                    if (b.second == c) k(s);
+                    return;
+                }
+            }
+            s.push_back({p.var, c});
+            k(s);
+            s.pop_back();
+            return;
+        }
+        for (int id : classNodes[c]) {
+            const ENode& n = nodes[id];
+            if (n.op != p.opId || n.arity != (int)p.children.size()) continue;
+            // match children left to right through nested continuations
+            function<void(int, Subst&)> step = [&](int i, Subst& cur) {
+                if (i == n.arity) {
+                    k(cur);
+                    return;
+                }
+                matchIn(p.children[i], kids[n.first + i], cur, [&](Subst& next) { step(i + 1, next); });
+            };
+            step(0, s);
+        }
+    }
+
+   public:
+    // all substitutions under which pattern p matches class c
+    vector<Subst> match(const Pattern& p, int c) {
+        vector<Subst> out;
+        Subst s;
+        matchIn(p, c, s, [&](Subst& found) { out.push_back(found); });
+        return out;
+    }
+
+    int instantiate(const Pattern& p, const Subst& s) {
+        if (p.var >= 0) {
+            for (auto& b : s) {
+                if (b.first == p.var) return b.second;
+            }
+            throw invalid_argument("pattern variable not bound by the substitution");
+        }
+        vector<int> children;
+        for (auto& ch : p.children) children.push_back(instantiate(ch, s));
+        return add(p.opId, children);
+    }
+
+    // --- extraction ---------------------------------------------------------
+
+    // smallest expression (by node count) represented by class c
+    string extract(int c) {
+        int n = classNodes.size();
+        vector<long long> cost(n, LLONG_MAX);
+        vector<int> best(n, -1);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int k = 0; k < n; k++) {
+                if (uf.find(k) != k) continue;
+                for (int id : classNodes[k]) {
+                    long long total = 1;
+                    for (int i = 0; i < nodes[id].arity && total < LLONG_MAX; i++) {
+                        long long ck = cost[uf.find(kids[nodes[id].first + i])];
+                        total = ck == LLONG_MAX ? LLONG_MAX : total + ck;
+                    }
+                    if (total < cost[k]) cost[k] = total, best[k] = id, changed = true;
+                }
+            }
+        }
+        function<string(int)> show = [&](int cls) -> string {
+            int id = best[uf.find(cls)];
+            if (nodes[id].arity == 0) return ops[nodes[id].op];
+            string s = "(" + ops[nodes[id].op];
+            for (int i = 0; i < nodes[id].arity; i++) s += " " + show(kids[nodes[id].first + i]);
+            return s + ")";
+        };
+        return show(c);
+    }
+};
+
+struct Rewrite {
+    string name;
+    EGraph::Pattern lhs, rhs;
+};
+
+Rewrite rewrite(EGraph& g, const string& name, const string& lhs, const string& rhs) {
+    map<string, int> vars;
+    Rewrite r;
+    r.name = name;
+    r.lhs = g.parse(lhs, vars);
+    size_t bound = vars.size();
+    r.rhs = g.parse(rhs, vars);
+    // variables are numbered by first appearance, so any the rhs added are unbound
+    for (auto& [var, id] : vars) {
+        if ((size_t)id >= bound) throw invalid_argument("rewrite " + name + ": " + var + " is not bound by the lhs");
+    }
+    return r;
+}
+
+// equality saturation: read all matches, then write, then rebuild once per
+// iteration; returns the number of iterations run (maxIterations if it did not
+// saturate, which is normal for rule sets that can grow forever)
+int saturate(EGraph& g, const vector<Rewrite>& rules, int maxIterations = 30, int maxNodes = 1000000) {
+    for (int iter = 1; iter <= maxIterations; iter++) {
+        vector<tuple<int, int, EGraph::Subst>> matches;
+        vector<int> classes = g.classes();
+        for (int r = 0; r < (int)rules.size(); r++) {
+            for (int c : classes) {
+                for (auto& s : g.match(rules[r].lhs, c)) matches.push_back({r, c, s});
+            }
+        }
+        int nodesBefore = g.numNodes(), unionsBefore = g.numUnions();
+        for (auto& [r, c, s] : matches) g.merge(c, g.instantiate(rules[r].rhs, s));
+        g.rebuild();
+        if (g.numNodes() == nodesBefore && g.numUnions() == unionsBefore) return iter;
+        if (g.numNodes() > maxNodes) return iter;
+    }
+    return maxIterations;
+}
+
+int main() {
+    // the classic example: (a * 2) / 2 simplifies to a
+    {
+        EGraph g;
+        int a = g.add("a"), two = g.add("2");
+        int root = g.add("/", {g.add("*", {a, two}), two});
+        vector<Rewrite> rules = {
+            rewrite(g, "comm-mul", "(* ?x ?y)", "(* ?y ?x)"),
+            rewrite(g, "assoc-div", "(/ (* ?x ?y) ?z)", "(* ?x (/ ?y ?z))"),
+            rewrite(g, "div-self", "(/ ?x ?x)", "1"),
+            rewrite(g, "mul-one", "(* ?x 1)", "?x"),
+        };
+        int iters = saturate(g, rules, 10);
+        cout << "(/ (* a 2) 2) => " << g.extract(root) << " after " << iters << " iterations, " << g.numNodes()
+             << " e-nodes in " << g.numClasses() << " classes" << endl;
+    }
+
+    // malformed patterns are rejected, not read past their end
+    {
+        EGraph g;
+        int rejected = 0;
+        for (string bad : {"(* ?x", "(* ?x ?y))", "()", "", "(+ a (f b)"}) {
+            map<string, int> vars;
+            try {
+                g.parse(bad, vars);
+            } catch (const invalid_argument&) {
+                rejected++;
+            }
+        }
+        cout << "Malformed patterns rejected: " << rejected << " of 5" << endl;
+        try {
+            rewrite(g, "unbound", "(* ?x 0)", "?y");
+            cout << "Unbound rhs variable accepted" << endl;
+        } catch (const invalid_argument& e) {
+            cout << "Unbound rhs variable rejected: " << e.what() << endl;
+        }
+    }
+
+    // congruence closure: f^k(x_i) towers, then x_0 = x_1 = ... = x_n collapses every level
+    auto towers = [](int n, int height, bool batched) {
+        EGraph g;
+        int f = g.op("f");
+        vector<int> leaves(n);
+        for (int i = 0; i < n; i++) {
+            leaves[i] = g.add("x" + to_string(i));
+            int t = leaves[i];
+            for (int h = 0; h < height; h++) t = g.add(f, {t});
+        }
+        auto start = chrono::high_resolution_clock::now();
+        for (int i = 0; i + 1 < n; i++) {
+            g.merge(leaves[i], leaves[i + 1]);
+            if (!batched) g.rebuild();
+        }
+        g.rebuild();
+        auto end = chrono::high_resolution_clock::now();
+        auto ms = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        cout << (batched ? "  deferred rebuild:  " : "  rebuild per merge: ") << g.numNodes() << " e-nodes, " << ms
+             << " ms, " << g.numClasses() << " classes left" << endl;
+    };
+    cout << "Congruence closure, 5000 towers of height 5:" << endl;
+    towers(5000, 5, false);
+    towers(5000, 5, true);
+    cout << "Congruence closure, 400000 towers of height 5:" << endl;
+    towers(400000, 5, true);
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include <bits/stdc++.h>
+#include "UnionFind.cpp"
+#include "../Tracing/SpanTrace.cpp"
+using namespace std;
+
+// Felzenszwalb-Huttenlocher graph-based segmentation on top of UnionFind.
+//
+// Pixels are vertices; 4-neighbour edges weigh |I(p) - I(q)| (8-bit, so a
+// 256-bucket counting sort replaces the comparison sort). Edges are visited in
+// increasing weight, and components A and B merge when
+//     w <= min(Int(A) + k / |A|, Int(B) + k / |B|)
+// where Int(C) is the largest edge weight inside C (the edge that last merged
+// it, thanks to the sorted order). A final pass absorbs components smaller
+// than minSize.
+//
+// The frame is cut into tiles. Each tile's internal edges are segmented by its
+// own thread. Tiles own disjoint pixels, so they write disjoint entries of the
+// shared forest. The seam edges between tiles are sorted and processed
+// afterwards with the same rule. This is the usual tiled approximation: within
+// a tile the order is exact, and across tiles it is exact per seam weight.
+// The result depends on the tile size but not on the thread count: every
+// tile is segmented the same way whichever thread takes it, and the demo
+// checks that 1 and N threads label every pixel identically.
+
+class SegmentationForest {
+   private:
+    UnionFind uf;
+    vector<int> size;
+    vector<float> internal;
+
+   public:
+    SegmentationForest(int n) : uf(n), size(n, 1), internal(n, 0.0f) {}
+
+    int find(int x) { return uf.find(x); }
+    int componentSize(int root) const { return size[root]; }
+    float internalDifference(int root) const { return internal[root]; }
+
+    // merge two roots joined by an edge of weight w
+    void merge(int a, int b, float w) {
+        uf.unionBySize(a, b, size);
+        internal[uf.find(a)] = w;
+    }
+};
+
+struct Edge {
+    int a, b;
+};
+
+struct SegmentationParams {
+    float k = 300.0f;
+    int minSize = 50;
+    int tile = 256;
+    int threads = max(1u, thread::hardware_concurrency());
+};
+
+// counting sort of 8-bit weighted edges; bucketStart gets 257 offsets
+void sortByWeight(const vector<Edge>& in, const vector<uint8_t>& w, vector<Edge>& out, vector<int>& bucketStart) {
+    bucketStart.assign(257, 0);
+    for (uint8_t x : w) bucketStart[x + 1]++;
+    for (int i = 0; i < 256; i++) bucketStart[i + 1] += bucketStart[i];
+    vector<int> fill(bucketStart.begin(), bucketStart.end() - 1);
+    out.resize(in.size());
+    for (size_t i = 0; i < in.size(); i++) out[fill[w[i]]++] = in[i];
+}
+
+void segmentEdges(SegmentationForest& f, const vector<Edge>& sorted, const vector<int>& bucketStart, float k) {
+    for (int weight = 0; weight < 256; weight++) {
+        for (int i = bucketStart[weight]; i < bucketStart[weight + 1]; i++) {
+            int a = f.find(sorted[i].a), b = f.find(sorted[i].b);
+            if (a == b) continue;
+            float ta = f.internalDifference(a) + k / f.componentSize(a);
+            float tb = f.internalDifference(b) + k / f.componentSize(b);
+            if (weight <= min(ta, tb)) f.merge(a, b, weight);
+        }
+    }
+}
+
+void absorbSmall(SegmentationForest& f, const vector<Edge>& sorted, int minSize) {
+    for (auto& e : sorted) {
+        int a = f.find(e.a), b = f.find(e.b);
+        if (a != b && (f.componentSize(a) < minSize || f.componentSize(b) < minSize)) {
+            f.merge(a, b, max(f.internalDifference(a), f.internalDifference(b)));
+        }
+    }
+}
+
+// returns a dense label per pixel and the number of segments
+int segmentImage(const vector<uint8_t>& img, int width, int height, const SegmentationParams& p, vector<int>& labels) {
+    SegmentationForest forest(width * height);
+    int tilesX = (width + p.tile - 1) / p.tile, tilesY = (height + p.tile - 1) / p.tile;
+    int tiles = tilesX * tilesY;
+    vector<vector<Edge>> seams(tiles);
+    vector<vector<uint8_t>> seamWeights(tiles);
+    vector<vector<Edge>> tileSorted(tiles);
+    atomic<int> nextTile(0);
+
+    auto worker = [&]() {
+        vector<Edge> edges;
+        vector<uint8_t> weights;
+        vector<int> bucketStart;
+        for (int t = nextTile++; t < tiles; t = nextTile++) {
+            SPAN("tile");
+            int x0 = (t % tilesX) * p.tile, y0 = (t / tilesX) * p.tile;
+            int x1 = min(width, x0 + p.tile), y1 = min(height, y0 + p.tile);
+            edges.clear();
+            weights.clear();
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    int i = y * width + x;
+                    if (x + 1 < width) {
+                        bool inside = x + 1 < x1;
+                        (inside ? edges : seams[t]).push_back({i, i + 1});
+                        (inside ? weights : seamWeights[t]).push_back(abs(img[i] - img[i + 1]));
+                    }
+                    if (y + 1 < height) {
+                        bool inside = y + 1 < y1;
+                        (inside ? edges : seams[t]).push_back({i, i + width});
+                        (inside ? weights : seamWeights[t]).push_back(abs(img[i] - img[i + width]));
+                    }
+                }
+            }
+            SPAN("sort + hook");
+            sortByWeight(edges, weights, tileSorted[t], bucketStart);
+            segmentEdges(forest, tileSorted[t], bucketStart, p.k);
+        }
+    };
+    vector<thread> pool;
+    for (int i = 0; i < p.threads; i++) pool.emplace_back(worker);
+    for (auto& th : pool) th.join();
+
+    // seams: sequential, they connect pixels owned by different tiles
+    vector<Edge> allSeams, seamSorted;
+    vector<uint8_t> allSeamWeights;
+    vector<int> bucketStart;
+    {
+        SPAN("seams");
+        for (int t = 0; t < tiles; t++) {
+            allSeams.insert(allSeams.end(), seams[t].begin(), seams[t].end());
+            allSeamWeights.insert(allSeamWeights.end(), seamWeights[t].begin(), seamWeights[t].end());
+        }
+        sortByWeight(allSeams, allSeamWeights, seamSorted, bucketStart);
+        segmentEdges(forest, seamSorted, bucketStart, p.k);
+    }
+
+    // tiny components: sweep the sorted edge lists again, in weight order per list
+    {
+        SPAN("absorb small");
+        for (int t = 0; t < tiles; t++) absorbSmall(forest, tileSorted[t], p.minSize);
+        absorbSmall(forest, seamSorted, p.minSize);
+    }
+
+    SPAN("relabel");
+    labels.assign(width * height, -1);
+    vector<int> dense(width * height, -1);
+    int segments = 0;
+    for (int i = 0; i < width * height; i++) {
+        int r = forest.find(i);
+        if (dense[r] < 0) dense[r] = segments++;
+        labels[i] = dense[r];
+    }
+    return segments;
+}
+
+// synthetic frame: a few smooth blobs over a gradient, plus sensor noise
+vector<uint8_t> makeFrame(int width, int height, unsigned seed) {
+    mt19937 rng(seed);
+    vector<array<int, 4>> blobs(24);
+    for (auto& b : blobs) b = {(int)(rng() % width), (int)(rng() % height), 80 + (int)(rng() % 300), (int)(rng() % 256)};
+    vector<uint8_t> img(width * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int v = (x * 64) / width + (y * 64) / height;
+            for (auto& b : blobs) {
+                long long dx = x - b[0], dy = y - b[1];
+                if (dx * dx + dy * dy < (long long)b[2] * b[2]) v = b[3];
+            }
+            v += (int)(rng() % 7) - 3;
+            img[y * width + x] = (uint8_t)min(255, max(0, v));
+        }
+    }
+    return img;
+}
+
+int main() {
+    const int width = 3840, height = 2160;
+    vector<uint8_t> frame = makeFrame(width, height, 17);
+    vector<int> labels, sequential;
+
+    SegmentationParams params;
+    // at least 4 threads, so tiles are taken out of order even on one core
+    for (int threads : {1, max(4, params.threads)}) {
+        params.threads = threads;
+        auto start = chrono::high_resolution_clock::now();
+        int segments;
+        {
+            SPAN("segment frame");
+            segments = segmentImage(frame, width, height, params, labels);
+        }
+        auto end = chrono::high_resolution_clock::now();
+        auto ms = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        cout << "4K frame, " << threads << " thread(s): " << segments << " segments in " << ms << " ms";
+        if (threads == 1) {
+            sequential = labels;
+            cout << endl;
+        } else {
+            cout << (labels == sequential ? ", labels match 1 thread" : ", labels MISMATCH 1 thread") << endl;
+        }
+    }
+    SPAN_TRACE_WRITE("ImageSegmentation.json");
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include <bits/stdc++.h>
+#include <immintrin.h>
+#include "UnionFind.cpp"
+using namespace std;
+
+// W independent union-find instances of the same size, interleaved so that
+// element i of every instance sits in one contiguous group:
+//   parent[i * W + lane], rank[i * W + lane]
+//
+// Monte Carlo experiments (percolation, random graphs) run many trials with
+// the same element set and the same operation sequence; only which unions
+// apply differs per trial. Running W trials in lock-step turns a find() on
+// element i into one walk with W lanes: every hop is a single gather, and the
+// loop ends when no lane moved. Unions take a lane mask saying which trials
+// perform them. Lanes that reach their root early simply stop moving while
+// the others finish.
+//
+// Linking is by rank and finds do not compress: depth stays below log2 n, and
+// compressing would mean lane-by-lane stores (AVX2 has gathers but no
+// scatters) into lines the next gathers read, which measured slower than the
+// hops it saves. Build with -mavx2 to get the vector path for W == 8;
+// otherwise every lane runs the scalar loop over the same interleaved layout.
+
+template <int W>
+class LaneUnionFind {
+    static_assert(W >= 1 && W <= 32, "lane masks are 32-bit");
+
+   private:
+    int n;
+    vector<int32_t> parent, rank;
+
+    int32_t findLane(int32_t x, int lane) const {
+        while (parent[x * W + lane] != x) x = parent[x * W + lane];
+        return x;
+    }
+
+   public:
+    typedef array<int32_t, W> Lanes;
+
+    LaneUnionFind(int n) : n(n), parent((size_t)n * W), rank((size_t)n * W) { reset(); }
+
+    // back to n singletons in every lane (start of the next batch of trials)
+    void reset() {
+        for (int i = 0; i < n; i++) {
+            for (int l = 0; l < W; l++) parent[i * W + l] = i;
+        }
+        fill(rank.begin(), rank.end(), 0);
+    }
+
+#ifdef __AVX2__
+    // Walk u and v together so the two chains of gathers overlap. The first
+    // hop is a plain load since parent[u * W ..] is contiguous; every later
+    // hop is one gather. Lanes outside `mask` may keep walking, their result
+    // is simply ignored.
+    void walk8(int u, int v, uint32_t mask, __m256i& ru, __m256i& rv) {
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const int32_t* base = parent.data();
+        __m256i xu = _mm256_set1_epi32(u), pu = _mm256_loadu_si256((const __m256i*)(base + u * 8));
+        __m256i xv = _mm256_set1_epi32(v), pv = _mm256_loadu_si256((const __m256i*)(base + v * 8));
+        auto lanesOf = [](__m256i m) { return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(m)); };
+        while ((~(lanesOf(_mm256_cmpeq_epi32(pu, xu)) & lanesOf(_mm256_cmpeq_epi32(pv, xv)))) & mask) {
+            xu = pu;
+            xv = pv;
+            pu = _mm256_i32gather_epi32(base, _mm256_add_epi32(_mm256_slli_epi32(xu, 3), lane), 4);
+            pv = _mm256_i32gather_epi32(base, _mm256_add_epi32(_mm256_slli_epi32(xv, 3), lane), 4);
+        }
+        ru = xu;
+        rv = xv;
+    }
+#endif
+
+    // roots of u and v in the lanes of mask (other lanes are unspecified)
+    void findPair(int u, int v, uint32_t mask, Lanes& ru, Lanes& rv) {
+#ifdef __AVX2__
+        if constexpr (W == 8) {
+            __m256i a, b;
+            walk8(u, v, mask, a, b);
+            _mm256_storeu_si256((__m256i*)ru.data(), a);
+            _mm256_storeu_si256((__m256i*)rv.data(), b);
+            return;
+        }
+#endif
+        for (uint32_t m = mask; m; m &= m - 1) {
+            int l = __builtin_ctz(m);
+            ru[l] = findLane(u, l);
+            rv[l] = findLane(v, l);
+        }
+    }
+
+    // root of element i in every lane
+    Lanes find(int i) {
+        Lanes root, unused;
+        findPair(i, i, W == 32 ? ~0u : (1u << W) - 1, root, unused);
+        return root;
+    }
+
+    // union u and v (by rank) in the lanes whose bit is set in mask
+    void unionSets(int u, int v, uint32_t mask) {
+        if (!mask) return;
+        Lanes ru, rv;
+        findPair(u, v, mask, ru, rv);
+        for (uint32_t m = mask; m; m &= m - 1) {
+            int l = __builtin_ctz(m);
+            int32_t a = ru[l], b = rv[l];
+            if (a == b) continue;
+            int32_t& rankA = rank[a * W + l];
+            int32_t& rankB = rank[b * W + l];
+            if (rankA < rankB) {
+                parent[a * W + l] = b;
+            } else {
+                parent[b * W + l] = a;
+                if (rankA == rankB) rankA++;
+            }
+        }
+    }
+
+    // bit l set when u and v are connected in lane l
+    uint32_t connected(int u, int v) {
+        Lanes ru, rv;
+        findPair(u, v, W == 32 ? ~0u : (1u << W) - 1, ru, rv);
+        uint32_t out = 0;
+        for (int l = 0; l < W; l++) out |= (uint32_t)(ru[l] == rv[l]) << l;
+        return out;
+    }
+};
+
+// Site percolation on an L x L grid: each site is open with probability p,
+// open neighbours are joined, and the grid percolates when the virtual top
+// node reaches the virtual bottom node. open[s] holds one bit per trial.
+template <int W>
+uint32_t percolateLanes(LaneUnionFind<W>& uf, int L, const vector<uint32_t>& open) {
+    int top = L * L, bottom = L * L + 1;
+    uf.reset();
+    for (int y = 0; y < L; y++) {
+        for (int x = 0; x < L; x++) {
+            int s = y * L + x;
+            uint32_t o = open[s];
+            if (!o) continue;
+            if (x > 0) uf.unionSets(s, s - 1, o & open[s - 1]);
+            if (y > 0) uf.unionSets(s, s - L, o & open[s - L]);
+            if (y == 0) uf.unionSets(s, top, o);
+            if (y == L - 1) uf.unionSets(s, bottom, o);
+        }
+    }
+    return uf.connected(top, bottom);
+}
+
+// the same trial on a plain UnionFind, reading one bit of the shared masks
+bool percolateSingle(int L, const vector<uint32_t>& open, int lane) {
+    int top = L * L, bottom = L * L + 1;
+    UnionFind uf(L * L + 2);
+    for (int y = 0; y < L; y++) {
+        for (int x = 0; x < L; x++) {
+            int s = y * L + x;
+            if (!(open[s] >> lane & 1)) continue;
+            if (x > 0 && (open[s - 1] >> lane & 1)) uf.unionSets(s, s - 1);
+            if (y > 0 && (open[s - L] >> lane & 1)) uf.unionSets(s, s - L);
+            if (y == 0) uf.unionSets(s, top);
+            if (y == L - 1) uf.unionSets(s, bottom);
+        }
+    }
+    return uf.connected(top, bottom);
+}
+
+void randomSites(vector<uint32_t>& open, int lanes, double p, mt19937& rng) {
+    uint32_t threshold = (uint32_t)(p * 4294967296.0);
+    for (auto& o : open) {
+        o = 0;
+        for (int l = 0; l < lanes; l++) o |= (uint32_t)(rng() < threshold) << l;
+    }
+}
+
+int main() {
+    const int W = 8;
+#ifdef __AVX2__
+    cout << "lanes: " << W << " (AVX2 gathers)" << endl;
+#else
+    cout << "lanes: " << W << " (scalar; build with -mavx2 for the vector path)" << endl;
+#endif
+    for (int L : {32, 64, 128, 256}) {
+        const int batches = max(4, (1 << 21) / (L * L) / W * W);  // ~2M sites per lane
+        LaneUnionFind<W> lanes(L * L + 2);
+        vector<uint32_t> open(L * L);
+        mt19937 rng(L);
+        long long lanesUs = 0, singleUs = 0;
+        int trials = 0, percolated = 0, mismatches = 0;
+        for (int b = 0; b < batches; b++) {
+            randomSites(open, W, 0.5927, rng);  // near the critical threshold
+
+            auto start = chrono::high_resolution_clock::now();
+            uint32_t hit = percolateLanes(lanes, L, open);
+            auto mid = chrono::high_resolution_clock::now();
+            uint32_t hitSingle = 0;
+            for (int l = 0; l < W; l++) hitSingle |= (uint32_t)percolateSingle(L, open, l) << l;
+            auto end = chrono::high_resolution_clock::now();
+
+            lanesUs += chrono::duration_cast<chrono::microseconds>(mid - start).count();
+            singleUs += chrono::duration_cast<chrono::microseconds>(end - mid).count();
+            trials += W;
+            percolated += __builtin_popcount(hit);
+            mismatches += __builtin_popcount(hit ^ hitSingle);
+        }
+        cout << L << "x" << L << ", " << trials << " trials at p = 0.5927: percolated " << fixed << setprecision(3)
+             << (double)percolated / trials << ", mismatches " << mismatches << endl;
+        cout << "  UnionFind per trial: " << setw(9) << (long long)(trials * 1e6 / max(1LL, singleUs))
+             << " trials/s" << endl;
+        cout << "  " << W << " lanes in lock-step: " << setw(9) << (long long)(trials * 1e6 / max(1LL, lanesUs))
+             << " trials/s" << endl;
+    }
+    return 0;
+}
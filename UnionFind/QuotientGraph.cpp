@@ -0,0 +1,415 @@
+#include <bits/stdc++.h>
+#include "UnionFind.cpp"
+#include "../Tracing/SpanTrace.cpp"
+using namespace std;
+
+// Quotient (contracted) graph from union-find labels.
+//
+// Every component becomes one vertex; edges inside a component vanish and
+// parallel edges between two components are merged into one with the summed
+// weight. The output is symmetric CSR, which is what a multilevel partitioner
+// feeds into its next coarsening round.
+//
+// No comparison sort anywhere:
+//   1. labels -> dense component ids (root marks + per-chunk prefix sums),
+//   2. one histogram + scatter pass (as in RadixUnion.cpp) puts both
+//      directions (cu, cv) and (cv, cu) of every cut edge into the bucket
+//      owning row cu; a bucket is a range of rows sized so that its entries
+//      fit a cache-resident table,
+//   3. threads take buckets off a shared counter and aggregate each one in a
+//      private open-addressing hash table keyed on (src, dst), then lay the
+//      distinct entries out as that bucket's CSR rows.
+// Buckets never share a row, so phase 3 needs no synchronisation beyond the
+// counter. Neighbours within a row come out in hash order, not sorted.
+
+typedef pair<int, int> Edge;
+
+struct QuotientGraph {
+    int n = 0;                       // number of components
+    vector<int> component;           // original vertex -> quotient vertex
+    vector<long long> vertexWeight;  // members per component
+    vector<long long> offsets;       // CSR row starts, size n + 1
+    vector<int> adj;
+    vector<long long> weight;        // aggregated edge weight, parallel to adj
+};
+
+namespace quotient_detail {
+
+template <class F>
+void parallelFor(int threads, F f) {
+    if (threads == 1) {
+        f(0);
+        return;
+    }
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(f, t);
+    for (auto& th : pool) th.join();
+}
+
+const size_t ENTRIES_PER_BUCKET = 1 << 13;  // 8K entries -> 256 KB table at load 1/2
+
+struct Entry {
+    int src, dst;
+    long long w;
+};
+
+// open addressing, linear probing; src == -1 marks an empty slot
+class EdgeTable {
+   private:
+    vector<Entry> slots;
+    size_t mask;
+
+   public:
+    void reset(size_t expected) {
+        size_t cap = 16;
+        while (cap < 2 * expected) cap <<= 1;
+        slots.assign(cap, {-1, -1, 0});
+        mask = cap - 1;
+    }
+
+    void add(int src, int dst, long long w) {
+        uint64_t key = (uint64_t)(uint32_t)src << 32 | (uint32_t)dst;
+        size_t i = (key * 0x9E3779B97F4A7C15ULL) >> 20 & mask;
+        while (true) {
+            Entry& e = slots[i];
+            if (e.src == src && e.dst == dst) {
+                e.w += w;
+                return;
+            }
+            if (e.src < 0) {
+                e = {src, dst, w};
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    const vector<Entry>& entries() const { return slots; }
+};
+
+}  // namespace quotient_detail
+
+// labels[i] is any representative in [0, n) shared by i's component, e.g. uf.find(i).
+// weights may be empty, in which case every edge counts 1.
+QuotientGraph buildQuotient(const vector<int>& labels, const vector<Edge>& edges,
+                            const vector<long long>& weights = vector<long long>(),
+                            int threads = thread::hardware_concurrency()) {
+    using namespace quotient_detail;
+    int n = labels.size();
+    size_t m = edges.size();
+    threads = max(1, min(threads, n / 4096 + 1));
+    QuotientGraph q;
+
+    // 1. dense ids: mark used labels, number them in index order
+    unique_ptr<atomic<uint8_t>[]> used(new atomic<uint8_t>[n]);
+    parallelFor(threads, [&](int t) {
+        SPAN("clear marks");
+        for (int i = (long long)n * t / threads; i < (long long)n * (t + 1) / threads; i++) used[i].store(0, memory_order_relaxed);
+    });
+    parallelFor(threads, [&](int t) {
+        SPAN("mark labels");
+        for (int i = (long long)n * t / threads; i < (long long)n * (t + 1) / threads; i++) {
+            used[labels[i]].store(1, memory_order_relaxed);
+        }
+    });
+    vector<int> id(n), chunkCount(threads + 1, 0);
+    parallelFor(threads, [&](int t) {
+        SPAN("count ids");
+        int c = 0;
+        for (int i = (long long)n * t / threads; i < (long long)n * (t + 1) / threads; i++) c += used[i].load(memory_order_relaxed);
+        chunkCount[t + 1] = c;
+    });
+    for (int t = 0; t < threads; t++) chunkCount[t + 1] += chunkCount[t];
+    parallelFor(threads, [&](int t) {
+        SPAN("assign ids");
+        int c = chunkCount[t];
+        for (int i = (long long)n * t / threads; i < (long long)n * (t + 1) / threads; i++) {
+            id[i] = used[i].load(memory_order_relaxed) ? c++ : -1;
+        }
+    });
+    q.n = chunkCount[threads];
+    q.component.resize(n);
+    parallelFor(threads, [&](int t) {
+        SPAN("relabel");
+        for (int i = (long long)n * t / threads; i < (long long)n * (t + 1) / threads; i++) q.component[i] = id[labels[i]];
+    });
+
+    // bucket b holds rows [b << shift, (b + 1) << shift); aim for a bucket's
+    // entries (both directions of its cut edges) to fit in L2
+    int shift = 0;
+    while (((size_t)q.n >> shift) > 1 && ((2 * m) >> shift) > ENTRIES_PER_BUCKET) shift++;
+    int buckets = ((max(q.n, 1) - 1) >> shift) + 1;
+
+    // 2. count, then scatter cut edges into buckets, both directions
+    vector<vector<size_t>> hist(threads, vector<size_t>(buckets + 1, 0));
+    parallelFor(threads, [&](int t) {
+        SPAN("histogram");
+        for (size_t i = m * t / threads; i < m * (t + 1) / threads; i++) {
+            int cu = q.component[edges[i].first], cv = q.component[edges[i].second];
+            if (cu == cv) continue;
+            hist[t][cu >> shift]++;
+            hist[t][cv >> shift]++;
+        }
+    });
+    // bucketStart[b] = sum over all threads of earlier buckets; hist[t][b] becomes thread t's write cursor
+    vector<size_t> bucketStart(buckets + 1, 0);
+    for (int b = 0; b < buckets; b++) {
+        size_t pos = bucketStart[b];
+        for (int t = 0; t < threads; t++) {
+            size_t c = hist[t][b];
+            hist[t][b] = pos;
+            pos += c;
+        }
+        bucketStart[b + 1] = pos;
+    }
+    vector<Entry> parts(bucketStart[buckets]);
+    parallelFor(threads, [&](int t) {
+        SPAN("scatter");
+        vector<size_t>& cursor = hist[t];
+        for (size_t i = m * t / threads; i < m * (t + 1) / threads; i++) {
+            int cu = q.component[edges[i].first], cv = q.component[edges[i].second];
+            if (cu == cv) continue;
+            long long w = weights.empty() ? 1 : weights[i];
+            parts[cursor[cu >> shift]++] = {cu, cv, w};
+            parts[cursor[cv >> shift]++] = {cv, cu, w};
+        }
+    });
+
+    // 3a. aggregate each bucket in a small private table, write the distinct
+    // entries back over the front of the bucket and count row degrees
+    q.offsets.assign(q.n + 1, 0);
+    vector<size_t> distinct(buckets + 1, 0);
+    atomic<int> next(0);
+    parallelFor(threads, [&](int) {
+        SPAN("aggregate buckets");
+        EdgeTable table;
+        for (int b; (b = next.fetch_add(1)) < buckets;) {
+            table.reset(bucketStart[b + 1] - bucketStart[b]);
+            for (size_t i = bucketStart[b]; i < bucketStart[b + 1]; i++) table.add(parts[i].src, parts[i].dst, parts[i].w);
+            size_t out = bucketStart[b];
+            for (const Entry& e : table.entries()) {
+                if (e.src < 0) continue;
+                q.offsets[e.src + 1]++;
+                parts[out++] = e;
+            }
+            distinct[b + 1] = out - bucketStart[b];
+        }
+    });
+    for (int b = 0; b < buckets; b++) distinct[b + 1] += distinct[b];
+
+    // 3b. each bucket's rows are contiguous: local prefix sum, then place entries
+    q.adj.resize(distinct[buckets]);
+    q.weight.resize(distinct[buckets]);
+    next = 0;
+    parallelFor(threads, [&](int) {
+        SPAN("lay out rows");
+        for (int b; (b = next.fetch_add(1)) < buckets;) {
+            long long base = distinct[b];
+            int lo = b << shift, hi = min(q.n, (b + 1) << shift);
+            for (int r = lo; r < hi; r++) {
+                long long deg = q.offsets[r + 1];
+                q.offsets[r + 1] = base;  // fill cursor for row r until the entries are placed
+                base += deg;
+            }
+            for (size_t i = bucketStart[b]; i < bucketStart[b] + distinct[b + 1] - distinct[b]; i++) {
+                long long pos = q.offsets[parts[i].src + 1]++;
+                q.adj[pos] = parts[i].dst;
+                q.weight[pos] = parts[i].w;
+            }
+        }
+    });
+
+    // vertex weights: one shared atomic counter per component (O(n) memory
+    // whatever the thread count); a thread adds runs of equal components at once
+    unique_ptr<atomic<int>[]> members(new atomic<int>[q.n]);
+    parallelFor(threads, [&](int t) {
+        SPAN("clear members");
+        for (int r = (long long)q.n * t / threads; r < (long long)q.n * (t + 1) / threads; r++) {
+            members[r].store(0, memory_order_relaxed);
+        }
+    });
+    parallelFor(threads, [&](int t) {
+        SPAN("count members");
+        int lo = (long long)n * t / threads, hi = (long long)n * (t + 1) / threads;
+        for (int i = lo; i < hi;) {
+            int c = q.component[i], run = 0;
+            for (; i < hi && q.component[i] == c; i++) run++;
+            members[c].fetch_add(run, memory_order_relaxed);
+        }
+    });
+    q.vertexWeight.resize(q.n);
+    parallelFor(threads, [&](int t) {
+        SPAN("copy members");
+        for (int r = (long long)q.n * t / threads; r < (long long)q.n * (t + 1) / threads; r++) {
+            q.vertexWeight[r] = members[r].load(memory_order_relaxed);
+        }
+    });
+    return q;
+}
+
+// flattens the UnionFind (find() compresses, so this part is sequential)
+QuotientGraph buildQuotient(UnionFind& uf, int n, const vector<Edge>& edges,
+                            const vector<long long>& weights = vector<long long>(),
+                            int threads = thread::hardware_concurrency()) {
+    vector<int> labels(n);
+    {
+        SPAN("compress");
+        for (int i = 0; i < n; i++) labels[i] = uf.find(i);
+    }
+    return buildQuotient(labels, edges, weights, threads);
+}
+
+// reference: map edges to components, sort, merge runs
+QuotientGraph sortedQuotient(const vector<int>& labels, const vector<Edge>& edges, const vector<long long>& weights) {
+    int n = labels.size();
+    QuotientGraph q;
+    vector<int> id(n, -1);
+    for (int i = 0; i < n; i++) {
+        if (id[labels[i]] < 0) id[labels[i]] = 0;
+    }
+    for (int i = 0; i < n; i++) {
+        if (id[i] >= 0) id[i] = q.n++;
+    }
+    q.component.resize(n);
+    q.vertexWeight.assign(q.n, 0);
+    for (int i = 0; i < n; i++) {
+        q.component[i] = id[labels[i]];
+        q.vertexWeight[q.component[i]]++;
+    }
+    vector<tuple<int, int, long long>> cut;
+    for (size_t i = 0; i < edges.size(); i++) {
+        int cu = q.component[edges[i].first], cv = q.component[edges[i].second];
+        if (cu == cv) continue;
+        long long w = weights.empty() ? 1 : weights[i];
+        cut.push_back({cu, cv, w});
+        cut.push_back({cv, cu, w});
+    }
+    sort(cut.begin(), cut.end());
+    q.offsets.assign(q.n + 1, 0);
+    for (size_t i = 0; i < cut.size(); i++) {
+        auto [s, d, w] = cut[i];
+        if (!q.adj.empty() && i > 0 && get<0>(cut[i - 1]) == s && get<1>(cut[i - 1]) == d) {
+            q.weight.back() += w;
+            continue;
+        }
+        q.adj.push_back(d);
+        q.weight.push_back(w);
+        q.offsets[s + 1]++;
+    }
+    for (int r = 0; r < q.n; r++) q.offsets[r + 1] += q.offsets[r];
+    return q;
+}
+
+bool sameQuotient(const QuotientGraph& a, const QuotientGraph& b) {
+    if (a.n != b.n || a.component != b.component || a.vertexWeight != b.vertexWeight || a.offsets != b.offsets) {
+        return false;
+    }
+    for (int r = 0; r < a.n; r++) {
+        vector<pair<int, long long>> ra, rb;
+        for (long long i = a.offsets[r]; i < a.offsets[r + 1]; i++) ra.push_back({a.adj[i], a.weight[i]});
+        for (long long i = b.offsets[r]; i < b.offsets[r + 1]; i++) rb.push_back({b.adj[i], b.weight[i]});
+        sort(ra.begin(), ra.end());
+        sort(rb.begin(), rb.end());
+        if (ra != rb) return false;
+    }
+    return true;
+}
+
+int main() {
+    const int side = 2048, n = side * side;
+    int maxThreads = max(1u, thread::hardware_concurrency());
+
+    // level 0: a 2D grid with unit weights
+    vector<Edge> edges;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            int v = y * side + x;
+            if (x + 1 < side) edges.push_back({v, v + 1});
+            if (y + 1 < side) edges.push_back({v, v + side});
+        }
+    }
+    vector<long long> weights;
+
+    // correctness and speed against the sort-based reference on one clustering
+    {
+        UnionFind uf(n);
+        mt19937 rng(11);
+        for (auto& e : edges) {
+            if (rng() % 4 == 0) uf.unionSets(e.first, e.second);
+        }
+        vector<int> labels(n);
+        for (int i = 0; i < n; i++) labels[i] = uf.find(i);
+
+        auto start = chrono::high_resolution_clock::now();
+        QuotientGraph ref = sortedQuotient(labels, edges, weights);
+        auto end = chrono::high_resolution_clock::now();
+        auto sortMs = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        cout << edges.size() << " edges -> " << ref.n << " components, " << ref.adj.size() / 2
+             << " quotient edges" << endl;
+        cout << "  sort + merge:        " << sortMs << " ms" << endl;
+        for (int threads : {1, maxThreads}) {
+            start = chrono::high_resolution_clock::now();
+            QuotientGraph q = buildQuotient(labels, edges, weights, threads);
+            end = chrono::high_resolution_clock::now();
+            cout << "  hash, " << threads << " thread(s):    "
+                 << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms ("
+                 << (sameQuotient(q, ref) ? "matches" : "DIFFERS") << ")" << endl;
+            if (threads == maxThreads) break;
+        }
+    }
+
+    // multilevel coarsening: each level joins every vertex with its heaviest
+    // neighbour with probability 1/2, then contracts
+    cout << "Coarsening levels:" << endl;
+    int level = 0, curN = n;
+    mt19937 rng(12);
+    auto total = chrono::high_resolution_clock::now();
+    while (curN > 64 && level < 20) {
+        // CSR of the current level, only for picking neighbours
+        vector<long long> off(curN + 1, 0);
+        for (auto& e : edges) off[e.first + 1]++, off[e.second + 1]++;
+        for (int i = 0; i < curN; i++) off[i + 1] += off[i];
+        vector<pair<int, long long>> nb(off[curN]);
+        vector<long long> pos(off.begin(), off.end() - 1);
+        for (size_t i = 0; i < edges.size(); i++) {
+            long long w = weights.empty() ? 1 : weights[i];
+            nb[pos[edges[i].first]++] = {edges[i].second, w};
+            nb[pos[edges[i].second]++] = {edges[i].first, w};
+        }
+        UnionFind uf(curN);
+        for (int v = 0; v < curN; v++) {
+            if (off[v] == off[v + 1] || rng() % 2) continue;
+            long long best = off[v];
+            for (long long i = off[v]; i < off[v + 1]; i++) {
+                if (nb[i].second > nb[best].second) best = i;
+            }
+            uf.unionSets(v, nb[best].first);
+        }
+
+        auto start = chrono::high_resolution_clock::now();
+        QuotientGraph q = buildQuotient(uf, curN, edges, weights);
+        auto end = chrono::high_resolution_clock::now();
+        cout << "  level " << setw(2) << level << ": " << setw(8) << curN << " -> " << setw(8) << q.n << " vertices, "
+             << setw(9) << q.adj.size() / 2 << " edges, "
+             << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+        // next level's edge list: each undirected edge once
+        edges.clear();
+        weights.clear();
+        for (int r = 0; r < q.n; r++) {
+            for (long long i = q.offsets[r]; i < q.offsets[r + 1]; i++) {
+                if (r < q.adj[i]) {
+                    edges.push_back({r, q.adj[i]});
+                    weights.push_back(q.weight[i]);
+                }
+            }
+        }
+        curN = q.n;
+        level++;
+    }
+    cout << "Total coarsening time: "
+         << chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - total).count() << " ms"
+         << endl;
+    SPAN_TRACE_WRITE("QuotientGraph.json");
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <bits/stdc++.h>
+#include "UnionFind.cpp"
+#include "../Tracing/SpanTrace.cpp"
+using namespace std;
+
+// Radix-partitioned bulk unions (the radix-join idea applied to union-find).
+//
+// Vertices are split into blocks small enough that a block's `parent` and
+// `rank` entries fit in cache. One histogram + scatter pass partitions the edge
+// list:
+//   - edges with both endpoints in block b go to bucket b,
+//   - edges crossing blocks are deferred, bucketed by the block of the smaller
+//     endpoint.
+// Pass 1 runs each bucket on its own and its working set is cache-resident.
+// If every tree of `uf` starts inside one block (true for a fresh UnionFind of
+// singletons), local unions keep it that way, buckets touch disjoint
+// `parent`/`rank` entries, and pass 1 can run them on several threads.
+// radixUnion checks that precondition up front (one find per vertex) and runs
+// pass 1 on one thread when a tree already spans blocks, since concurrent
+// unions would then race on the shared roots. Pass 2 applies the deferred
+// cross-block edges in block order.
+
+typedef pair<int, int> Edge;
+
+struct RadixUnionStats {
+    long long localEdges = 0, crossEdges = 0;
+    bool parallelSafe = true;  // every tree of uf started inside one block
+    long long partitionUs = 0, localUs = 0, crossUs = 0;
+};
+
+// uf may hold earlier unions; pass 1 only goes parallel if its trees are
+// block-local (see above)
+RadixUnionStats radixUnion(UnionFind& uf, int n, const vector<Edge>& edges, size_t cacheBytes = 256 << 10,
+                           int threads = thread::hardware_concurrency()) {
+    RadixUnionStats stats;
+    // parent + rank = 8 bytes per vertex; round the block down to a power of two
+    int shift = 0;
+    while (((size_t)2 << shift) * 8 <= cacheBytes) shift++;
+    int blocks = (n >> shift) + 1;
+    threads = max(1, threads);
+
+    auto t0 = chrono::high_resolution_clock::now();
+    if (threads > 1) {
+        SPAN("check block-local trees");
+        for (int v = 0; v < n && stats.parallelSafe; v++) stats.parallelSafe = uf.find(v) >> shift == v >> shift;
+        if (!stats.parallelSafe) threads = 1;
+    }
+    // slot b = local bucket b, slot blocks + b = deferred bucket b
+    vector<size_t> start(2 * (size_t)blocks + 1, 0);
+    vector<Edge> parts(edges.size());
+    {
+        SPAN("partition");
+        for (auto& e : edges) {
+            int a = min(e.first, e.second) >> shift, b = max(e.first, e.second) >> shift;
+            start[(a == b ? a : blocks + a) + 1]++;
+        }
+        for (size_t i = 0; i + 1 < start.size(); i++) start[i + 1] += start[i];
+        vector<size_t> fillPos(start.begin(), start.end() - 1);
+        for (auto& e : edges) {
+            int a = min(e.first, e.second) >> shift, b = max(e.first, e.second) >> shift;
+            parts[fillPos[a == b ? a : blocks + a]++] = e;
+        }
+    }
+    stats.localEdges = start[blocks];
+    stats.crossEdges = edges.size() - start[blocks];
+    auto t1 = chrono::high_resolution_clock::now();
+
+    // pass 1: buckets are independent, hand them out round-robin
+    auto runBuckets = [&](int id) {
+        SPAN("hook local buckets");
+        for (int b = id; b < blocks; b += threads) {
+            for (size_t i = start[b]; i < start[b + 1]; i++) uf.unionSets(parts[i].first, parts[i].second);
+        }
+    };
+    if (threads == 1) {
+        runBuckets(0);
+    } else {
+        vector<thread> pool;
+        for (int t = 0; t < threads; t++) pool.emplace_back(runBuckets, t);
+        for (auto& t : pool) t.join();
+    }
+    auto t2 = chrono::high_resolution_clock::now();
+
+    // pass 2: cross-block edges, already grouped by the smaller endpoint's block
+    {
+        SPAN("hook cross edges");
+        for (size_t i = start[blocks]; i < parts.size(); i++) uf.unionSets(parts[i].first, parts[i].second);
+    }
+    auto t3 = chrono::high_resolution_clock::now();
+
+    stats.partitionUs = chrono::duration_cast<chrono::microseconds>(t1 - t0).count();
+    stats.localUs = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+    stats.crossUs = chrono::duration_cast<chrono::microseconds>(t3 - t2).count();
+    return stats;
+}
+
+unsigned long long componentSignature(UnionFind& uf, int n) {
+    // number of components plus a hash of the partition that ignores root choice
+    SPAN("compress + relabel");
+    vector<int> firstSeen(n, -1);
+    unsigned long long components = 0, h = 0;
+    for (int i = 0; i < n; i++) {
+        int r = uf.find(i);
+        if (firstSeen[r] < 0) {
+            firstSeen[r] = i;
+            components++;
+        }
+        h = h * 1000003 + firstSeen[r];
+    }
+    return components ^ (h << 20);
+}
+
+void benchmark(const string& name, int n, const vector<Edge>& edges) {
+    UnionFind plain(n);
+    auto start = chrono::high_resolution_clock::now();
+    {
+        SPAN("sequential unionSets");
+        for (auto& e : edges) plain.unionSets(e.first, e.second);
+    }
+    auto end = chrono::high_resolution_clock::now();
+    auto plainUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+    UnionFind radix(n);
+    start = chrono::high_resolution_clock::now();
+    RadixUnionStats s = radixUnion(radix, n, edges);
+    end = chrono::high_resolution_clock::now();
+    auto radixUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+    cout << name << ":\n";
+    cout << "  sequential unionSets: " << plainUs << " microseconds\n";
+    cout << "  radix-partitioned:    " << radixUs << " microseconds (partition " << s.partitionUs << ", local "
+         << s.localUs << ", cross " << s.crossUs << "; " << s.localEdges << " local / " << s.crossEdges
+         << " cross edges)\n";
+    cout << "  partitions " << (componentSignature(plain, n) == componentSignature(radix, n) ? "match" : "DIFFER")
+         << endl;
+}
+
+int main() {
+    const int n = 1 << 23;
+    const int m = 1 << 24;
+    mt19937 rng(2024);
+
+    // mesh-like input: most edges connect nearby vertices, a few jump far away
+    vector<Edge> local(m);
+    for (auto& e : local) {
+        int u = rng() % n;
+        int v = (rng() % 100 < 95) ? min(n - 1, u + (int)(rng() % 64)) : (int)(rng() % n);
+        e = {u, v};
+    }
+    shuffle(local.begin(), local.end(), rng);
+    benchmark("Mostly-local edges", n, local);
+
+    vector<Edge> uniform(m);
+    for (auto& e : uniform) e = {(int)(rng() % n), (int)(rng() % n)};
+    benchmark("Uniform random edges", n, uniform);
+
+    // a forest that already spans blocks must not be hooked in parallel
+    UnionFind merged(n), reference(n);
+    for (int i = 0; i < 1000; i++) {
+        merged.unionSets(i, n - 1 - i);
+        reference.unionSets(i, n - 1 - i);
+    }
+    RadixUnionStats s = radixUnion(merged, n, local, 256 << 10, 4);
+    for (auto& e : local) reference.unionSets(e.first, e.second);
+    cout << "Pre-merged forest: pass 1 ran " << (s.parallelSafe ? "in parallel" : "on one thread") << ", partitions "
+         << (componentSignature(merged, n) == componentSignature(reference, n) ? "match" : "DIFFER") << endl;
+    SPAN_TRACE_WRITE("RadixUnion.json");
+    return 0;
+}
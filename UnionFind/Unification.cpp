@@ -0,0 +1,312 @@
+#include <bits/stdc++.h>
+#include "UnionFind.cpp"
+using namespace std;
+
+// First-order term unification (the core of Hindley-Milner inference) on UnionFind.
+//
+// Terms live in a flat arena: a term is either a variable or a constructor
+// symbol applied to `arity` argument terms stored contiguously in `args`.
+// Every term is also a UnionFind element. Each equivalence class keeps one
+// representative constructor term at its root (or -1 while it only holds
+// variables), so binding a variable is a union and looking it up is a find.
+// There is no substitution map to compose or walk.
+//
+// unify() works through an explicit stack of pending pairs, so deep or huge
+// terms never recurse. The occurs check is optional:
+//   OCCURS_EAGER - check every variable-to-constructor binding (classic, can
+//                  be quadratic on long chains)
+//   OCCURS_NONE  - skip it; call acyclic() once at the end for a linear-time
+//                  check of the whole solution
+// A failed unify() leaves the merges it made before the clash in place, like
+// the usual destructive implementations.
+
+enum OccursCheck { OCCURS_NONE, OCCURS_EAGER };
+
+class TermArena {
+   public:
+    struct Term {
+        int symbol;    // -1 for variables
+        int firstArg;
+        int arity;
+    };
+
+   private:
+    vector<Term> terms;
+    vector<int> args;
+    vector<string> symbols;
+    unordered_map<string, int> symbolIds;
+
+   public:
+    int symbol(const string& name) {
+        auto it = symbolIds.find(name);
+        if (it != symbolIds.end()) return it->second;
+        symbols.push_back(name);
+        return symbolIds[name] = symbols.size() - 1;
+    }
+
+    int var() {
+        terms.push_back({-1, 0, 0});
+        return terms.size() - 1;
+    }
+
+    int ctor(int sym, const vector<int>& children) {
+        terms.push_back({sym, (int)args.size(), (int)children.size()});
+        args.insert(args.end(), children.begin(), children.end());
+        return terms.size() - 1;
+    }
+
+    int ctor(const string& name, const vector<int>& children) { return ctor(symbol(name), children); }
+
+    const Term& operator[](int t) const { return terms[t]; }
+    int arg(int t, int i) const { return args[terms[t].firstArg + i]; }
+    const string& name(int sym) const { return symbols[sym]; }
+    int size() const { return terms.size(); }
+};
+
+class Unifier {
+   private:
+    TermArena& arena;
+    UnionFind uf;
+    vector<int> structure;  // structure[root] = constructor term of the class, or -1
+    OccursCheck occurs;
+    vector<pair<int, int>> pending;
+    vector<int> mark;
+    int stamp = 0;
+    string lastError;
+
+    // make UnionFind / structure cover terms created since the last call
+    void sync() {
+        while ((int)structure.size() < arena.size()) {
+            int t = uf.makeSet();
+            structure.push_back(arena[t].symbol >= 0 ? t : -1);
+            mark.push_back(0);
+        }
+    }
+
+    // does class `root` occur inside constructor term t?
+    bool occursIn(int root, int t) {
+        ++stamp;
+        vector<int> stack = {t};
+        while (!stack.empty()) {
+            int c = uf.find(stack.back());
+            stack.pop_back();
+            if (c == root) return true;
+            if (mark[c] == stamp) continue;
+            mark[c] = stamp;
+            int s = structure[c];
+            if (s < 0) continue;
+            for (int i = 0; i < arena[s].arity; i++) stack.push_back(arena.arg(s, i));
+        }
+        return false;
+    }
+
+    void link(int ra, int rb, int keep) {
+        uf.unionSets(ra, rb);
+        structure[uf.find(ra)] = keep;
+    }
+
+   public:
+    Unifier(TermArena& arena, OccursCheck occurs = OCCURS_EAGER) : arena(arena), uf(0), occurs(occurs) { sync(); }
+
+    bool unify(int a, int b) {
+        sync();
+        pending.assign(1, {a, b});
+        while (!pending.empty()) {
+            auto [x, y] = pending.back();
+            pending.pop_back();
+            int rx = uf.find(x), ry = uf.find(y);
+            if (rx == ry) continue;
+            int sx = structure[rx], sy = structure[ry];
+            if (sx >= 0 && sy >= 0) {
+                const TermArena::Term &tx = arena[sx], &ty = arena[sy];
+                if (tx.symbol != ty.symbol || tx.arity != ty.arity) {
+                    lastError = "cannot unify " + arena.name(tx.symbol) + "/" + to_string(tx.arity) + " with " +
+                                arena.name(ty.symbol) + "/" + to_string(ty.arity);
+                    return false;
+                }
+                link(rx, ry, sx);
+                for (int i = 0; i < tx.arity; i++) pending.push_back({arena.arg(sx, i), arena.arg(sy, i)});
+            } else if (sx >= 0 || sy >= 0) {
+                int varRoot = sx >= 0 ? ry : rx, ctorTerm = sx >= 0 ? sx : sy;
+                if (occurs == OCCURS_EAGER && occursIn(varRoot, ctorTerm)) {
+                    lastError = "occurs check: variable would contain itself";
+                    return false;
+                }
+                link(rx, ry, ctorTerm);
+            } else {
+                link(rx, ry, -1);
+            }
+        }
+        return true;
+    }
+
+    // linear-time occurs check over the whole solution (three-colour DFS on classes)
+    bool acyclic() {
+        sync();
+        int n = arena.size();
+        vector<char> color(n, 0);
+        vector<pair<int, int>> stack;  // (class root, next argument)
+        for (int t = 0; t < n; t++) {
+            int r = uf.find(t);
+            if (color[r]) continue;
+            color[r] = 1;
+            stack.push_back({r, 0});
+            while (!stack.empty()) {
+                auto& [c, i] = stack.back();
+                int s = structure[c];
+                if (s < 0 || i == arena[s].arity) {
+                    color[c] = 2;
+                    stack.pop_back();
+                    continue;
+                }
+                int child = uf.find(arena.arg(s, i++));
+                if (color[child] == 1) return false;
+                if (color[child] == 0) {
+                    color[child] = 1;
+                    stack.push_back({child, 0});
+                }
+            }
+        }
+        return true;
+    }
+
+    const string& error() const { return lastError; }
+
+    // pretty-print the solved form of t, variables shown as 'tN' by class root
+    string show(int t, int depthLimit = 8) {
+        int r = uf.find(t);
+        int s = structure[r];
+        if (s < 0) return "t" + to_string(r);
+        if (depthLimit == 0) return "...";
+        string out = arena.name(arena[s].symbol);
+        if (arena[s].arity == 0) return out;
+        out += "(";
+        for (int i = 0; i < arena[s].arity; i++) {
+            if (i) out += ", ";
+            out += show(arena.arg(s, i), depthLimit - 1);
+        }
+        return out + ")";
+    }
+};
+
+// What the config type checker does today: a map from variable to term,
+// resolved by walking binding chains with no compression.
+class MapSubstitution {
+   private:
+    TermArena& arena;
+    unordered_map<int, int> binding;
+
+    int walk(int t) {
+        while (arena[t].symbol < 0) {
+            auto it = binding.find(t);
+            if (it == binding.end()) break;
+            t = it->second;
+        }
+        return t;
+    }
+
+   public:
+    MapSubstitution(TermArena& arena) : arena(arena) {}
+
+    bool unify(int a, int b) {
+        vector<pair<int, int>> pending = {{a, b}};
+        while (!pending.empty()) {
+            auto [x, y] = pending.back();
+            pending.pop_back();
+            x = walk(x), y = walk(y);
+            if (x == y) continue;
+            if (arena[x].symbol < 0) {
+                binding[x] = y;
+            } else if (arena[y].symbol < 0) {
+                binding[y] = x;
+            } else {
+                if (arena[x].symbol != arena[y].symbol || arena[x].arity != arena[y].arity) return false;
+                for (int i = 0; i < arena[x].arity; i++) pending.push_back({arena.arg(x, i), arena.arg(y, i)});
+            }
+        }
+        return true;
+    }
+};
+
+// Constraint workload: long chains of variable equalities (v[i] = v[i+1],
+// given back to front so map substitution walks ever-longer chains), plus
+// function types hanging off the chain.
+void buildConstraints(TermArena& arena, int n, vector<pair<int, int>>& constraints) {
+    int fn = arena.symbol("->"), intT = arena.symbol("Int"), boolT = arena.symbol("Bool");
+    int i0 = arena.ctor(intT, {}), b0 = arena.ctor(boolT, {});
+    vector<int> v(n);
+    for (int i = 0; i < n; i++) v[i] = arena.var();
+    for (int i = n - 2; i >= 0; i--) constraints.push_back({v[i + 1], v[i]});
+    for (int i = 0; i < n; i += 2) {
+        int a = arena.var(), b = arena.var();
+        constraints.push_back({v[i], arena.ctor(fn, {a, b})});
+        constraints.push_back({a, i0});
+        constraints.push_back({b, arena.ctor(fn, {b0, arena.var()})});
+    }
+}
+
+int main() {
+    // textbook example: (a -> b) = (Int -> c), c = List(a)
+    {
+        TermArena arena;
+        int a = arena.var(), b = arena.var(), c = arena.var();
+        int intT = arena.ctor("Int", {});
+        Unifier u(arena);
+        bool ok = u.unify(arena.ctor("->", {a, b}), arena.ctor("->", {intT, c}));
+        ok = ok && u.unify(c, arena.ctor("List", {a}));
+        cout << "unify: " << (ok ? "ok" : u.error()) << ", b = " << u.show(b) << endl;
+
+        // a = List(a) must be rejected by the occurs check
+        int d = arena.var();
+        bool cyclic = u.unify(d, arena.ctor("List", {d}));
+        cout << "d = List(d): " << (cyclic ? "accepted?!" : u.error()) << endl;
+    }
+
+    // quadratic map-substitution vs union-find, on the same constraints
+    {
+        const int n = 20000;
+        TermArena arena;
+        vector<pair<int, int>> constraints;
+        buildConstraints(arena, n, constraints);
+
+        auto start = chrono::high_resolution_clock::now();
+        MapSubstitution sub(arena);
+        bool okMap = true;
+        for (auto& c : constraints) okMap &= sub.unify(c.first, c.second);
+        auto end = chrono::high_resolution_clock::now();
+        auto mapUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+        start = chrono::high_resolution_clock::now();
+        Unifier u(arena, OCCURS_NONE);
+        bool okUf = true;
+        for (auto& c : constraints) okUf &= u.unify(c.first, c.second);
+        okUf &= u.acyclic();
+        end = chrono::high_resolution_clock::now();
+        auto ufUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+        cout << constraints.size() << " constraints: map substitution " << mapUs << " microseconds ("
+             << (okMap ? "ok" : "fail") << "), union-find " << ufUs << " microseconds (" << (okUf ? "ok" : "fail")
+             << ")" << endl;
+    }
+
+    // scale
+    {
+        const int n = 2000000;
+        TermArena arena;
+        vector<pair<int, int>> constraints;
+        buildConstraints(arena, n, constraints);
+        for (OccursCheck mode : {OCCURS_NONE, OCCURS_EAGER}) {
+            auto start = chrono::high_resolution_clock::now();
+            Unifier u(arena, mode);
+            bool ok = true;
+            for (auto& c : constraints) ok &= u.unify(c.first, c.second);
+            if (mode == OCCURS_NONE) ok &= u.acyclic();
+            auto end = chrono::high_resolution_clock::now();
+            auto ms = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+            cout << constraints.size() << " constraints, occurs check "
+                 << (mode == OCCURS_NONE ? "once at the end" : "on every binding") << ": " << ms << " ms ("
+                 << (ok ? "ok" : "fail") << ")" << endl;
+        }
+    }
+    return 0;
+}
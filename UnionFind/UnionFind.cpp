@@ -14,6 +14,13 @@ class UnionFind {
         }
     }
 
+    // add a new singleton set and return its element
+    int makeSet() {
+        parent.push_back(parent.size());
+        rank.push_back(0);
+        return parent.size() - 1;
+    }
+
     int find(int u) {
         if (parent[u] != u) {
             parent[u] = find(parent[u]);  // Path compression
@@ -0,0 +1,306 @@
+#include <bits/stdc++.h>
+#include "UnionFind.cpp"
+using namespace std;
+
+// Asynchronous union ingestion.
+//
+// Producers never touch the UnionFind. Each producer thread owns a Producer
+// handle with its own edge buffer; a full (or stale) buffer is handed to the
+// shared queue as one chunk, so the queue lock is taken once per chunk rather
+// than once per edge. A single consumer thread drains whole batches and
+// applies them in arrival order. With IngestConfig::blockSort it first buckets
+// a batch by vertex block with a counting sort, so consecutive finds land on
+// nearby `parent` cache lines; that only pays when edges are already mostly
+// local, so it is off by default.
+//
+// Latency: the consumer wakes at least every maxLatency / 2 and then takes
+// every non-empty producer buffer itself, so an edge is applied within about
+// maxLatency even if its producer goes idle and never calls flush(). Each
+// buffer is guarded by a one-byte spin flag: the producer sets it per add()
+// (uncontended, one atomic exchange), the consumer only ever try-locks it and
+// skips a buffer whose producer is mid-add (that producer checks its own
+// latency every 64 edges).
+//
+// The queue does not make bulk unions faster: it lets producers go on
+// without waiting for union work, at the cost of the consumer applying it
+// later (on another core, ideally).
+
+struct IngestConfig {
+    size_t batchSize = 1 << 16;              // consumer wakes once this many edges are queued
+    size_t producerBuffer = 4096;            // edges buffered per producer before handing off
+    chrono::microseconds maxLatency{2000};   // about how long an edge may wait, idle producers included
+    bool blockSort = false;                  // bucket each batch by vertex block before applying
+    int blockShift = 12;                     // vertices per block = 2^blockShift
+};
+
+class UnionIngestQueue {
+   public:
+    typedef pair<int, int> Edge;
+
+    class Producer {
+       private:
+        friend class UnionIngestQueue;
+        UnionIngestQueue* q;
+        vector<Edge> buf;
+        chrono::steady_clock::time_point oldest;
+        atomic<bool> busy{false};  // guards buf against the consumer's sweep
+
+        void lock() {
+            while (busy.exchange(true, memory_order_acquire)) this_thread::yield();
+        }
+        bool tryLock() { return !busy.exchange(true, memory_order_acquire); }
+        void unlock() { busy.store(false, memory_order_release); }
+
+        // caller holds the flag; the swap leaves buf empty with its capacity
+        void handOff() {
+            vector<Edge> chunk;
+            chunk.reserve(q->cfg.producerBuffer);
+            chunk.swap(buf);
+            q->submit(move(chunk));
+        }
+
+       public:
+        Producer(UnionIngestQueue* q) : q(q) {
+            buf.reserve(q->cfg.producerBuffer);
+            q->enroll(this);
+        }
+        Producer(const Producer&) = delete;
+        Producer& operator=(const Producer&) = delete;
+        ~Producer() {
+            flush();
+            q->leave(this);
+        }
+
+        void add(int u, int v) {
+            lock();
+            if (buf.empty()) oldest = chrono::steady_clock::now();
+            buf.push_back({u, v});
+            // the clock is only read every 64 edges to keep enqueue cheap
+            if (buf.size() >= q->cfg.producerBuffer ||
+                ((buf.size() & 63) == 0 && chrono::steady_clock::now() - oldest >= q->cfg.maxLatency)) {
+                handOff();
+            }
+            unlock();
+        }
+
+        // hand the buffer to the consumer now rather than at its next sweep
+        void flush() {
+            lock();
+            if (!buf.empty()) handOff();
+            unlock();
+        }
+    };
+
+   private:
+    IngestConfig cfg;
+    UnionFind uf;
+    int n;
+
+    mutex m;
+    condition_variable wake, done;
+    vector<vector<Edge>> ready;
+    size_t readyEdges = 0;
+    long long submitted = 0, applied = 0;
+    bool stopping = false;
+    thread consumer;
+
+    vector<Edge> scratch;         // blockSort only
+    vector<size_t> bucketStart;   // blockSort only
+    long long applyUs = 0;        // consumer time spent applying (and sorting)
+
+    // lock order: registry -> a producer's flag -> m
+    mutex registry;
+    vector<Producer*> producers;
+
+    void enroll(Producer* p) {
+        lock_guard<mutex> lock(registry);
+        producers.push_back(p);
+    }
+
+    void leave(Producer* p) {
+        lock_guard<mutex> lock(registry);
+        producers.erase(find(producers.begin(), producers.end(), p));
+    }
+
+    // take the buffers of producers that are not mid-add
+    void sweepProducers() {
+        lock_guard<mutex> lock(registry);
+        for (Producer* p : producers) {
+            if (!p->tryLock()) continue;
+            if (!p->buf.empty()) p->handOff();
+            p->unlock();
+        }
+    }
+
+    void submit(vector<Edge>&& chunk) {
+        size_t k = chunk.size();
+        bool wakeNow;
+        {
+            lock_guard<mutex> lock(m);
+            ready.push_back(move(chunk));
+            readyEdges += k;
+            submitted += k;
+            wakeNow = readyEdges >= cfg.batchSize;
+        }
+        if (wakeNow) wake.notify_one();
+    }
+
+    void applyBatch(vector<vector<Edge>>& chunks) {
+        if (!cfg.blockSort) {
+            for (auto& c : chunks) {
+                for (auto& e : c) uf.unionSets(e.first, e.second);
+            }
+            return;
+        }
+        // counting sort by block of the smaller endpoint, then apply in order
+        size_t total = 0;
+        int blocks = (n >> cfg.blockShift) + 1;
+        fill(bucketStart.begin(), bucketStart.end(), 0);
+        for (auto& c : chunks) {
+            for (auto& e : c) {
+                if (e.first > e.second) swap(e.first, e.second);
+                bucketStart[(e.first >> cfg.blockShift) + 1]++;
+            }
+            total += c.size();
+        }
+        for (int b = 0; b < blocks; b++) bucketStart[b + 1] += bucketStart[b];
+        scratch.resize(total);
+        for (auto& c : chunks) {
+            for (auto& e : c) scratch[bucketStart[e.first >> cfg.blockShift]++] = e;
+        }
+        for (auto& e : scratch) uf.unionSets(e.first, e.second);
+    }
+
+    void consume() {
+        vector<vector<Edge>> batch;
+        unique_lock<mutex> lock(m);
+        while (true) {
+            bool woken = wake.wait_for(lock, cfg.maxLatency / 2,
+                                       [&] { return stopping || readyEdges >= cfg.batchSize; });
+            if (!woken) {
+                // timed out: collect what idle producers are sitting on
+                lock.unlock();
+                sweepProducers();
+                lock.lock();
+            }
+            if (ready.empty()) {
+                if (stopping) return;
+                continue;
+            }
+            batch.swap(ready);
+            size_t k = readyEdges;
+            readyEdges = 0;
+            lock.unlock();
+
+            auto start = chrono::steady_clock::now();
+            applyBatch(batch);
+            applyUs += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+            batch.clear();
+
+            lock.lock();
+            applied += k;
+            done.notify_all();
+        }
+    }
+
+   public:
+    UnionIngestQueue(int n, IngestConfig cfg = IngestConfig())
+        : cfg(cfg), uf(n), n(n) {
+        if (cfg.blockSort) bucketStart.resize((n >> cfg.blockShift) + 2);
+        consumer = thread([this] { consume(); });
+    }
+
+    ~UnionIngestQueue() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        wake.notify_one();
+        consumer.join();
+    }
+
+    Producer producer() { return Producer(this); }
+
+    // block until every edge submitted so far has been applied
+    void drain() {
+        unique_lock<mutex> lock(m);
+        wake.notify_one();
+        done.wait(lock, [&] { return applied == submitted; });
+    }
+
+    long long appliedEdges() {
+        lock_guard<mutex> lock(m);
+        return applied;
+    }
+
+    // only meaningful after drain(); the consumer owns these otherwise
+    UnionFind& unionFind() { return uf; }
+    long long consumerApplyUs() const { return applyUs; }
+};
+
+int countComponents(UnionFind& uf, int n) {
+    int components = 0;
+    for (int i = 0; i < n; i++) {
+        if (uf.find(i) == i) components++;
+    }
+    return components;
+}
+
+int main() {
+    const int n = 1 << 22;
+    const long long m = 1LL << 22;
+    const int producers = 4;
+
+    vector<pair<int, int>> edges(m);
+    mt19937 rng(7);
+    for (auto& e : edges) e = {(int)(rng() % n), (int)(rng() % n)};
+
+    auto start = chrono::high_resolution_clock::now();
+    UnionFind direct(n);
+    for (auto& e : edges) direct.unionSets(e.first, e.second);
+    auto end = chrono::high_resolution_clock::now();
+    auto directUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+    int directComponents = countComponents(direct, n);
+
+    cout << "Direct unionSets:   " << directUs << " microseconds, " << directComponents << " components\n";
+
+    IngestConfig cfg;
+    cfg.batchSize = 1 << 20;
+    for (bool blockSort : {false, true}) {
+        cfg.blockSort = blockSort;
+        start = chrono::high_resolution_clock::now();
+        UnionIngestQueue queue(n, cfg);
+        vector<thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                UnionIngestQueue::Producer h(&queue);
+                for (long long i = p; i < m; i += producers) h.add(edges[i].first, edges[i].second);
+            });
+        }
+        for (auto& t : threads) t.join();
+        auto ingested = chrono::high_resolution_clock::now();
+        queue.drain();
+        end = chrono::high_resolution_clock::now();
+        auto queuedUs = chrono::duration_cast<chrono::microseconds>(end - start).count();
+        auto ingestUs = chrono::duration_cast<chrono::microseconds>(ingested - start).count();
+        int queuedComponents = countComponents(queue.unionFind(), n);
+
+        cout << "Ingestion queue (" << producers << " producers, " << (blockSort ? "block-sorted" : "arrival order")
+             << "): producers done after " << ingestUs << " microseconds, fully applied after " << queuedUs
+             << " microseconds, " << queuedComponents << " components\n";
+        cout << "  of which the consumer spent " << queue.consumerApplyUs() << " microseconds applying\n";
+        cout << (directComponents == queuedComponents ? "Results match." : "RESULTS DIFFER!") << endl;
+    }
+    cfg.blockSort = false;
+
+    // an idle producer: a few edges, then silence and no flush()
+    {
+        UnionIngestQueue idle(n, cfg);
+        UnionIngestQueue::Producer h(&idle);
+        for (int i = 0; i < 10; i++) h.add(i, i + 1);
+        this_thread::sleep_for(cfg.maxLatency * 2);
+        cout << "Idle producer, " << cfg.maxLatency.count() * 2 << " microseconds after its last add: "
+             << idle.appliedEdges() << " of 10 edges applied" << endl;
+    }
+    return 0;
+}